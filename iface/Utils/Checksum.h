@@ -0,0 +1,273 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <Utils/CpuFeatures.h>
+
+
+namespace Utils
+{
+
+template<typename H>
+concept IsHasher = requires(H hasher, const std::span<const std::byte> bytes)
+{
+    typename H::Digest;
+    hasher.update(bytes);
+    { hasher.digest() } -> std::same_as<typename H::Digest>;
+};
+
+
+using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>;
+
+static constexpr Crc32cTables makeCrc32cTables() noexcept
+{
+    constexpr uint32_t Polynomial = 0x82F63B78u; // reflected 0x1EDC6F41
+    Crc32cTables tables{};
+    for(uint32_t index = 0u; index < 256u; ++index)
+    {
+        uint32_t crc = index;
+        for(int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (Polynomial & (0u - (crc & 1u)));
+        }
+        tables[0][index] = crc;
+    }
+    for(uint32_t index = 0u; index < 256u; ++index)
+    {
+        for(size_t slice = 1u; slice < tables.size(); ++slice)
+        {
+            const uint32_t previous = tables[slice - 1u][index];
+            tables[slice][index] = (previous >> 8) ^ tables[0][previous & 0xFFu];
+        }
+    }
+    return tables;
+}
+
+// CRC-32C (Castagnoli), the checksum of iSCSI, ext4 and most storage formats.
+// Uses the SSE4.2 crc32 instruction when present, slicing-by-8 tables otherwise.
+class Crc32c
+{
+public:
+    using Digest = uint32_t;
+
+    explicit Crc32c(const bool hardware = cpuFeatures().sse42) noexcept
+        : useHardware{hardware && cpuFeatures().sse42}
+    {}
+
+    void update(const std::span<const std::byte> bytes) noexcept
+    {
+#if defined(UTILS_SIMD_X86)
+        if(useHardware)
+        {
+            state = updateHardware(state, bytes.data(), bytes.size());
+            return;
+        }
+#endif
+        state = updateTable(state, bytes.data(), bytes.size());
+    }
+
+    Digest digest() const noexcept
+    {
+        return ~state;
+    }
+
+    void reset() noexcept
+    {
+        state = ~uint32_t{0};
+    }
+
+private:
+    static uint32_t updateTable(uint32_t crc, const std::byte* data, size_t size) noexcept
+    {
+        static constexpr Crc32cTables Table = makeCrc32cTables();
+        for(; size >= 8u; data += 8, size -= 8u)
+        {
+            uint64_t word = 0u;
+            std::memcpy(&word, data, sizeof(word));
+            word ^= crc;
+            crc = Table[7][ word        & 0xFFu] ^ Table[6][(word >>  8) & 0xFFu]
+                ^ Table[5][(word >> 16) & 0xFFu] ^ Table[4][(word >> 24) & 0xFFu]
+                ^ Table[3][(word >> 32) & 0xFFu] ^ Table[2][(word >> 40) & 0xFFu]
+                ^ Table[1][(word >> 48) & 0xFFu] ^ Table[0][ word >> 56        ];
+        }
+        for(; size; ++data, --size)
+        {
+            crc = (crc >> 8) ^ Table[0][(crc ^ static_cast<uint32_t>(*data)) & 0xFFu];
+        }
+        return crc;
+    }
+
+#if defined(UTILS_SIMD_X86)
+    UTILS_TARGET("sse4.2")
+    static uint32_t updateHardware(uint32_t crc, const std::byte* data, size_t size) noexcept
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        uint64_t wide = crc;
+        for(; size >= 8u; data += 8, size -= 8u)
+        {
+            uint64_t word = 0u;
+            std::memcpy(&word, data, sizeof(word));
+            wide = _mm_crc32_u64(wide, word);
+        }
+        crc = static_cast<uint32_t>(wide);
+#endif
+        for(; size >= 4u; data += 4, size -= 4u)
+        {
+            uint32_t word = 0u;
+            std::memcpy(&word, data, sizeof(word));
+            crc = _mm_crc32_u32(crc, word);
+        }
+        for(; size; ++data, --size)
+        {
+            crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*data));
+        }
+        return crc;
+    }
+#endif
+
+    uint32_t state = ~uint32_t{0};
+    bool useHardware;
+
+}; // class Crc32c
+
+
+// XXH64, a fast non cryptographic hash for integrity checks of large blocks.
+class XxHash64
+{
+public:
+    using Digest = uint64_t;
+
+    explicit XxHash64(const uint64_t hashSeed = 0u) noexcept
+        : seed{hashSeed}
+    {
+        reset();
+    }
+
+    void update(const std::span<const std::byte> bytes) noexcept
+    {
+        const std::byte* data = bytes.data();
+        size_t size = bytes.size();
+        if(0u == size)
+        {
+            return;
+        }
+        total += size;
+
+        if(buffered)
+        {
+            const size_t taken = std::min(size, Stripe - buffered);
+            std::memcpy(buffer.data() + buffered, data, taken);
+            buffered += taken;
+            data += taken;
+            size -= taken;
+            if(buffered < Stripe)
+            {
+                return;
+            }
+            consume(buffer.data());
+            buffered = 0u;
+        }
+        for(; size >= Stripe; data += Stripe, size -= Stripe)
+        {
+            consume(data);
+        }
+        std::memcpy(buffer.data(), data, size);
+        buffered = size;
+    }
+
+    Digest digest() const noexcept
+    {
+        uint64_t hash = total >= Stripe
+            ? std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18)
+            : seed + Prime5;
+        if(total >= Stripe)
+        {
+            for(const uint64_t lane : lanes)
+            {
+                hash = (hash ^ round(0u, lane)) * Prime1 + Prime4;
+            }
+        }
+        hash += total;
+
+        const std::byte* data = buffer.data();
+        size_t size = buffered;
+        for(; size >= 8u; data += 8, size -= 8u)
+        {
+            hash ^= round(0u, load<uint64_t>(data));
+            hash = std::rotl(hash, 27) * Prime1 + Prime4;
+        }
+        if(size >= 4u)
+        {
+            hash ^= uint64_t{load<uint32_t>(data)} * Prime1;
+            hash = std::rotl(hash, 23) * Prime2 + Prime3;
+            data += 4;
+            size -= 4u;
+        }
+        for(; size; ++data, --size)
+        {
+            hash ^= static_cast<uint64_t>(*data) * Prime5;
+            hash = std::rotl(hash, 11) * Prime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= Prime2;
+        hash ^= hash >> 29;
+        hash *= Prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    void reset() noexcept
+    {
+        lanes = {seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1};
+        total = 0u;
+        buffered = 0u;
+    }
+
+private:
+    static constexpr uint64_t Prime1 = 11400714785074694791ull;
+    static constexpr uint64_t Prime2 = 14029467366897019727ull;
+    static constexpr uint64_t Prime3 =  1609587929392839161ull;
+    static constexpr uint64_t Prime4 =  9650029242287828579ull;
+    static constexpr uint64_t Prime5 =  2870177450012600261ull;
+    static constexpr size_t   Stripe = 32u;
+
+    template<typename T>
+    static T load(const std::byte* const data) noexcept
+    {
+        T value{};
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static constexpr uint64_t round(const uint64_t accumulator, const uint64_t input) noexcept
+    {
+        return std::rotl(accumulator + input * Prime2, 31) * Prime1;
+    }
+
+    void consume(const std::byte* const stripe) noexcept
+    {
+        for(size_t lane = 0u; lane < lanes.size(); ++lane)
+        {
+            lanes[lane] = round(lanes[lane], load<uint64_t>(stripe + lane * 8u));
+        }
+    }
+
+    uint64_t seed;
+    std::array<uint64_t, 4> lanes{};
+    std::array<std::byte, Stripe> buffer{};
+    uint64_t total = 0u;
+    size_t buffered = 0u;
+
+}; // class XxHash64
+
+} // namespace Utils
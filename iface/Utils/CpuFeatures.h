@@ -0,0 +1,62 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define UTILS_SIMD_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define UTILS_TARGET(features)
+#else
+#include <immintrin.h>
+#define UTILS_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+
+namespace Utils
+{
+
+struct CpuFeatures
+{
+    bool sse2  = false;
+    bool sse42 = false;
+    bool avx2  = false;
+};
+
+static CpuFeatures detectCpuFeatures() noexcept
+{
+    CpuFeatures features;
+#if defined(UTILS_SIMD_X86)
+#if defined(_MSC_VER)
+    int info[4]{};
+    ::__cpuid(info, 0);
+    const int maxLeaf = info[0];
+    ::__cpuid(info, 1);
+    features.sse2  = 0 != (info[3] & (1 << 26));
+    features.sse42 = 0 != (info[2] & (1 << 20));
+    const bool osAvx = 0 != (info[2] & (1 << 27)) // OSXSAVE
+                    && 0 != (info[2] & (1 << 28)) // AVX
+                    && 6u == (::_xgetbv(0) & 6u); // XMM and YMM state saved by the OS
+    if(maxLeaf >= 7)
+    {
+        ::__cpuidex(info, 7, 0);
+        features.avx2 = osAvx && 0 != (info[1] & (1 << 5));
+    }
+#else
+    features.sse2  = __builtin_cpu_supports("sse2");
+    features.sse42 = __builtin_cpu_supports("sse4.2");
+    features.avx2  = __builtin_cpu_supports("avx2");
+#endif
+#endif
+    return features;
+}
+
+static const CpuFeatures& cpuFeatures() noexcept
+{
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
+
+} // namespace Utils
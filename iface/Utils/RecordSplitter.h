@@ -0,0 +1,158 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <Utils/CpuFeatures.h>
+
+
+namespace Utils
+{
+
+enum class SimdLevel
+{
+      Scalar
+    , Sse2
+    , Avx2
+};
+
+static SimdLevel detectSimdLevel() noexcept
+{
+    const CpuFeatures& features = cpuFeatures();
+    if(features.avx2)
+    {
+        return SimdLevel::Avx2;
+    }
+    if(features.sse2)
+    {
+        return SimdLevel::Sse2;
+    }
+    return SimdLevel::Scalar;
+}
+
+static SimdLevel bestSimdLevel() noexcept
+{
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+
+// Splits buffers into records terminated by a delimiter byte. The records are spans
+// into the scanned buffer, nothing is copied. The scan kernel is picked at run time.
+class RecordSplitter
+{
+public:
+    explicit RecordSplitter(  const std::byte recordDelimiter = std::byte{'\n'}
+                            , const SimdLevel requestedLevel = bestSimdLevel() ) noexcept
+        : delimiter{recordDelimiter}
+        , level{std::min(requestedLevel, bestSimdLevel())}
+    {}
+
+    SimdLevel simdLevel() const noexcept
+    {
+        return level;
+    }
+
+    // Calls `record` for every complete record in `data`, without its delimiter.
+    // Returns the unterminated tail, which the caller carries over into the next buffer.
+    template<typename R>
+    std::span<const std::byte> split(const std::span<const std::byte> data, R&& record) const
+    {
+        const std::byte* recordBegin = data.data();
+        auto found = [&](const std::byte* const position)
+        {
+            record(std::span<const std::byte>{recordBegin, position});
+            recordBegin = position + 1;
+        };
+
+        const std::byte* const end = data.data() + data.size();
+        const std::byte* scanned = data.data();
+#if defined(UTILS_SIMD_X86)
+        switch(level)
+        {
+        case SimdLevel::Avx2:
+            scanned = scanAvx2(scanned, end, delimiter, found);
+            [[fallthrough]];
+        case SimdLevel::Sse2:
+            scanned = scanSse2(scanned, end, delimiter, found);
+            break;
+        default:
+            break;
+        }
+#endif
+        scanScalar(scanned, end, delimiter, found);
+        return std::span<const std::byte>{recordBegin, end};
+    }
+
+    // Same as `split`, but the unterminated tail, if any, is reported as the last record.
+    template<typename R>
+    void splitAll(const std::span<const std::byte> data, R&& record) const
+    {
+        const auto tail = split(data, record);
+        if(!tail.empty())
+        {
+            record(tail);
+        }
+    }
+
+private:
+    template<typename F>
+    static void scanScalar(const std::byte* position, const std::byte* const end, const std::byte delimiter, F& found)
+    {
+        for(; position < end; ++position)
+        {
+            if(*position == delimiter)
+            {
+                found(position);
+            }
+        }
+    }
+
+#if defined(UTILS_SIMD_X86)
+    template<typename F>
+    static void reportMask(const std::byte* const block, uint32_t mask, F& found)
+    {
+        while(mask)
+        {
+            found(block + std::countr_zero(mask));
+            mask &= mask - 1u;
+        }
+    }
+
+    template<typename F>
+    static const std::byte* scanSse2(const std::byte* block, const std::byte* const end, const std::byte delimiter, F& found)
+    {
+        const __m128i pattern = _mm_set1_epi8(static_cast<char>(delimiter));
+        for(; end - block >= 16; block += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+            reportMask(block, static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, pattern))), found);
+        }
+        return block;
+    }
+
+    template<typename F>
+    UTILS_TARGET("avx2")
+    static const std::byte* scanAvx2(const std::byte* block, const std::byte* const end, const std::byte delimiter, F& found)
+    {
+        const __m256i pattern = _mm256_set1_epi8(static_cast<char>(delimiter));
+        for(; end - block >= 32; block += 32)
+        {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            reportMask(block, static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, pattern))), found);
+        }
+        return block;
+    }
+#endif
+
+    std::byte delimiter;
+    SimdLevel level;
+
+}; // class RecordSplitter
+
+} // namespace Utils
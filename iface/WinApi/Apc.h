@@ -0,0 +1,98 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Handle.h>
+#include <functional>
+#include <memory>
+
+
+namespace WinApi
+{
+
+// Runs on the target thread inside an alertable wait, so it must not throw.
+using ApcRoutine = std::function<void()>;
+
+static void CALLBACK runApcRoutine(const ULONG_PTR parameter)
+{
+    const std::unique_ptr<ApcRoutine> routine{reinterpret_cast<ApcRoutine*>(parameter)};
+    (*routine)();
+}
+
+// The routine runs the next time `thread` waits alertably, e.g. waitFor(handle, timeout, Alertable),
+// which then returns WaitStatus::IoCompletion. Routines run in the order they were queued.
+static Maybe<void> queueApc(const HANDLE thread, ApcRoutine&& routine)
+{
+    auto queued = std::make_unique<ApcRoutine>(std::move(routine));
+    if(0u == ::QueueUserAPC(&runApcRoutine, thread, reinterpret_cast<ULONG_PTR>(queued.get())))
+    {
+        return OccurredError{};
+    }
+    queued.release(); // runApcRoutine owns it now
+    return {};
+}
+
+// Runs the routines already queued to the calling thread without blocking,
+// true if there were any.
+static bool runQueuedApcs() noexcept
+{
+    return WAIT_IO_COMPLETION == ::SleepEx(0u, TRUE);
+}
+
+static auto threadHandleOf(const HANDLE thread)
+{
+    return safeHandle(thread, [](const HANDLE thread)
+    {
+        ::CloseHandle(thread);
+    });
+}
+using ThreadHandle = decltype(threadHandleOf(nullptr));
+
+// Work queue of one thread: any thread posts routines, the owner runs them whenever it
+// waits alertably, so one thread can drive many operations without a dispatcher of its own.
+// The handle is also signaled when the thread exits.
+class ApcQueue
+{
+public:
+    static Maybe<ApcQueue> ofCurrentThread()
+    {
+        HANDLE thread = nullptr;
+        if(FALSE == ::DuplicateHandle
+        (
+              ::GetCurrentProcess()
+            , ::GetCurrentThread()
+            , ::GetCurrentProcess()
+            , &thread
+            , THREAD_SET_CONTEXT | SYNCHRONIZE
+            , FALSE
+            , 0u
+        ))
+        {
+            return OccurredError{};
+        }
+        return ApcQueue{threadHandleOf(thread)};
+    }
+
+    ApcQueue() noexcept = default;
+
+    Maybe<void> post(ApcRoutine routine) const
+    {
+        return queueApc(thread.get(), std::move(routine));
+    }
+
+    const ThreadHandle& handle() const noexcept
+    {
+        return thread;
+    }
+
+private:
+    explicit ApcQueue(ThreadHandle&& owner) noexcept
+        : thread{std::move(owner)}
+    {}
+
+    ThreadHandle thread;
+
+}; // class ApcQueue
+
+} // namespace WinApi
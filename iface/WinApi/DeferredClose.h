@@ -0,0 +1,221 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Handle.h>
+#include <WinApi/Trace.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+
+namespace WinApi
+{
+
+struct DeferredCloseOptions
+{
+    size_t backlog = 4096u;     // handles waiting for the closer, rounded up to a power of two
+};
+
+struct DeferredCloseStats
+{
+    std::atomic<uint64_t> deferred{0u};
+    std::atomic<uint64_t> inlined{0u};      // closed by the caller, mostly when the backlog was full
+    Trace::Histogram deferredLatency;       // of the close itself on the closer thread
+    Trace::Histogram inlineLatency;
+};
+
+// Handles whose deleter has no state, which is all the library creates, e.g. createFile,
+// createEvent or createHeap.
+template<typename C>
+concept IsStatelessClose = std::is_empty_v<C> && std::default_initializable<C> && std::invocable<C, HANDLE>;
+
+// Closes handles on a background thread, since CloseHandle of a file with a lot of dirty
+// data can take milliseconds. Handles go through a bounded lock-free queue. When it is full
+// the caller closes the handle itself, which slows it down to the closer's pace
+// instead of growing the backlog.
+class DeferredCloser
+{
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0u};
+        HANDLE asset = nullptr;
+        void (*close)(HANDLE) = nullptr;
+    };
+
+public:
+    explicit DeferredCloser(const DeferredCloseOptions& options = {})
+        : mask{std::bit_ceil(std::max<size_t>(options.backlog, 2u)) - 1u}
+        , slots{std::make_unique<Slot[]>(mask + 1u)}
+    {
+        for(size_t index = 0u; index <= mask; ++index)
+        {
+            slots[index].sequence.store(index, std::memory_order_relaxed);
+        }
+        closer = std::thread{[this]{ closeLoop(); }};
+    }
+
+    DeferredCloser(const DeferredCloser&) = delete;
+    DeferredCloser& operator = (const DeferredCloser&) = delete;
+
+    ~DeferredCloser()
+    {
+        drain();
+        stopping.store(true, std::memory_order_release);
+        pending.fetch_add(1u, std::memory_order_acq_rel);
+        pending.notify_all();
+        closer.join();
+    }
+
+    template<typename C>
+    requires IsStatelessClose<C>
+    void close(Handle<C>&& handle)
+    {
+        if(!handle)
+        {
+            return;
+        }
+        if(0u == pending.fetch_add(1u, std::memory_order_acq_rel))
+        {
+            pending.notify_all();
+        }
+        if(push(handle.get(), &closeWith<C>))
+        {
+            handle.release();
+            closerStats.deferred.fetch_add(1u, std::memory_order_relaxed);
+            return;
+        }
+        finished();
+        closeInline(std::move(handle));
+    }
+
+    // Closes right away, counted in the inline latency to compare with deferred closes.
+    template<typename C>
+    void closeInline(Handle<C>&& handle)
+    {
+        const auto started = Trace::Clock::now();
+        handle.reset();
+        closerStats.inlineLatency.record(Trace::Clock::now() - started);
+        closerStats.inlined.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    // Returns once every handle passed to close before has been closed, e.g. at shutdown
+    // or before the files are opened again exclusively.
+    void drain()
+    {
+        for(size_t left = pending.load(std::memory_order_acquire); 0u != left; left = pending.load(std::memory_order_acquire))
+        {
+            pending.wait(left, std::memory_order_acquire);
+        }
+    }
+
+    const DeferredCloseStats& stats() const noexcept
+    {
+        return closerStats;
+    }
+
+private:
+    template<typename C>
+    static void closeWith(const HANDLE asset)
+    {
+        C{}(asset);
+    }
+
+    // Bounded multi-producer queue with a sequence number per slot.
+    bool push(const HANDLE asset, void (*const closeAsset)(HANDLE)) noexcept
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            Slot& slot = slots[position & mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<ptrdiff_t>(sequence - position);
+            if(0 == lag)
+            {
+                if(tail.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed))
+                {
+                    slot.asset = asset;
+                    slot.close = closeAsset;
+                    slot.sequence.store(position + 1u, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(lag < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(HANDLE& asset, void (*&closeAsset)(HANDLE)) noexcept
+    {
+        Slot& slot = slots[head & mask];
+        if(slot.sequence.load(std::memory_order_acquire) != head + 1u)
+        {
+            return false;
+        }
+        asset = slot.asset;
+        closeAsset = slot.close;
+        slot.sequence.store(head + mask + 1u, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    void finished() noexcept
+    {
+        if(1u == pending.fetch_sub(1u, std::memory_order_acq_rel))
+        {
+            pending.notify_all();
+        }
+    }
+
+    void closeLoop()
+    {
+        for(;;)
+        {
+            HANDLE asset = nullptr;
+            void (*closeAsset)(HANDLE) = nullptr;
+            if(pop(asset, closeAsset))
+            {
+                const auto started = Trace::Clock::now();
+                closeAsset(asset);
+                closerStats.deferredLatency.record(Trace::Clock::now() - started);
+                finished();
+                continue;
+            }
+            if(stopping.load(std::memory_order_acquire))
+            {
+                return;
+            }
+            if(0u == pending.load(std::memory_order_acquire))
+            {
+                pending.wait(0u, std::memory_order_acquire);
+            }
+            else
+            {
+                std::this_thread::yield(); // a producer is between counting and publishing
+            }
+        }
+    }
+
+    const size_t mask;
+    const std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<size_t> tail{0u};
+    alignas(64) size_t head = 0u;               // closer thread only
+    alignas(64) std::atomic<size_t> pending{0u}; // counted before they are queued
+    std::atomic<bool> stopping{false};
+    DeferredCloseStats closerStats;
+    std::thread closer;
+
+}; // class DeferredCloser
+
+} // namespace WinApi
@@ -0,0 +1,420 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Apc.h>
+#include <WinApi/Sync/Event.h>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+namespace WinApi
+{
+
+struct FiberOptions
+{
+    size_t stackCommit  = 0u;           // 0 for the size the executable asks for
+    size_t stackReserve = 64u << 10;    // the system adds a guard page below the stack
+    size_t pooledFibers = 1024u;        // finished fibers kept to run later tasks on their stacks
+};
+
+// Runs tasks as fibers on the thread which calls run(). A task which waits parks its fiber,
+// see fiberWaitFor and fiberReadAt, and the scheduler switches to the next ready one.
+// When none is ready the thread sleeps alertably, wake-ups arrive as APCs or I/O completion
+// routines, so a single thread serves any number of outstanding waits.
+// Only those calls park: a plain waitFor, fileRead or any other blocking call in a task
+// blocks the thread, and with it every fiber of the scheduler, until it returns.
+class FiberScheduler
+{
+    struct Worker
+    {
+        FiberScheduler* scheduler = nullptr;
+        LPVOID fiber = nullptr;
+        std::function<void()> task;
+        Worker* nextReady = nullptr;
+    };
+
+public:
+    using Wake = std::function<void()>;
+
+    explicit FiberScheduler(const FiberOptions& schedulerOptions = {})
+        : options{schedulerOptions}
+    {}
+
+    FiberScheduler(const FiberScheduler&) = delete;
+    FiberScheduler& operator = (const FiberScheduler&) = delete;
+
+    ~FiberScheduler()
+    {
+        for(const auto& worker : workers)
+        {
+            ::DeleteFiber(worker->fiber);
+        }
+    }
+
+    // Scheduler running on the calling thread, null outside of run().
+    static FiberScheduler* current() noexcept
+    {
+        return running();
+    }
+
+    // Can also be called by the tasks themselves.
+    void spawn(std::function<void()> task)
+    {
+        tasks.push_back(std::move(task));
+    }
+
+    // Returns when all tasks have finished. The first exception a task has thrown is
+    // rethrown once the others are done. When a fiber for a task can't be created the
+    // error is returned once the fibers already started are done, tasks which have not
+    // started stay queued.
+    Maybe<void> run()
+    {
+        auto queue = ApcQueue::ofCurrentThread();
+        if(!queue.okay())
+        {
+            return Maybe<void>{queue.code()};
+        }
+        self = std::move(queue).value();
+        auto signal = Sync::createAutoEvent();
+        if(!signal.okay())
+        {
+            return Maybe<void>{signal.code()};
+        }
+        handedOver = std::move(signal).value();
+
+        bool converted = true;
+        mainFiber = ::ConvertThreadToFiberEx(nullptr, FIBER_FLAG_FLOAT_SWITCH);
+        if(!mainFiber)
+        {
+            if(ERROR_ALREADY_FIBER != ::GetLastError())
+            {
+                return OccurredError{};
+            }
+            mainFiber = ::GetCurrentFiber();
+            converted = false;
+        }
+
+        FiberScheduler* const outer = std::exchange(running(), this);
+        Maybe<void> result = loop();
+        running() = outer;
+
+        if(converted)
+        {
+            ::ConvertFiberToThread();
+        }
+        if(failure)
+        {
+            std::rethrow_exception(std::exchange(failure, nullptr));
+        }
+        return result;
+    }
+
+    // True on a fiber of this scheduler, where park and yield may be called.
+    bool inFiber() const noexcept
+    {
+        return nullptr != active;
+    }
+
+    // Lets the other ready fibers run first.
+    void yield()
+    {
+        makeReady(active);
+        ::SwitchToFiber(mainFiber);
+    }
+
+    // Parks the running fiber. `start` gets the callable which makes the fiber ready again,
+    // it must be called on the scheduler thread, e.g. from an APC or a completion routine.
+    // The fiber is not parked when `start` fails.
+    Maybe<void> park(const std::function<Maybe<void>(Wake wake)>& start)
+    {
+        Worker* const worker = active;
+        auto started = start([this, worker]() noexcept
+        {
+            --parked;
+            makeReady(worker);
+        });
+        if(!started.okay())
+        {
+            return started;
+        }
+        ++parked;
+        ::SwitchToFiber(mainFiber);
+        return {};
+    }
+
+    // Wakes a fiber parked by a wait on another thread.
+    const ApcQueue& queue() const noexcept
+    {
+        return self;
+    }
+
+    // Runs `wake` on the scheduler thread, called from any thread. Wake-ups go as APCs,
+    // one which can't be queued is handed over through a list the scheduler drains.
+    void post(Wake wake)
+    {
+        if(self.post(ApcRoutine{wake}).okay())
+        {
+            return;
+        }
+        {
+            std::lock_guard lock{handOverMutex};
+            handOver.push_back(std::move(wake));
+        }
+        handOverPending.store(true, std::memory_order_release);
+        Sync::setEvent(handedOver);
+    }
+
+    // Fibers which exist now, running, parked or pooled, each one owns a stack.
+    size_t liveFibers() const noexcept
+    {
+        return workers.size();
+    }
+
+private:
+    static FiberScheduler*& running() noexcept
+    {
+        static thread_local FiberScheduler* scheduler = nullptr;
+        return scheduler;
+    }
+
+    static void CALLBACK fiberMain(const LPVOID parameter)
+    {
+        Worker& worker = *static_cast<Worker*>(parameter);
+        for(;;)
+        {
+            try
+            {
+                worker.task();
+            }
+            catch(...)
+            {
+                if(!worker.scheduler->failure)
+                {
+                    worker.scheduler->failure = std::current_exception();
+                }
+            }
+            worker.task = nullptr;
+            worker.scheduler->finished.push_back(&worker);
+            ::SwitchToFiber(worker.scheduler->mainFiber);
+        }
+    }
+
+    // Wakes run inside APCs, which must not throw, so the ready list is linked through
+    // the workers and never allocates.
+    void makeReady(Worker* const worker) noexcept
+    {
+        worker->nextReady = nullptr;
+        (readyLast ? readyLast->nextReady : readyFirst) = worker;
+        readyLast = worker;
+    }
+
+    Worker* takeReady() noexcept
+    {
+        Worker* const worker = readyFirst;
+        readyFirst = worker->nextReady;
+        if(!readyFirst)
+        {
+            readyLast = nullptr;
+        }
+        return worker;
+    }
+
+    Maybe<Worker*> worker()
+    {
+        if(!idle.empty())
+        {
+            Worker* pooled = idle.back();
+            idle.pop_back();
+            return pooled;
+        }
+        auto created = std::make_unique<Worker>();
+        created->scheduler = this;
+        created->fiber = ::CreateFiberEx
+        (
+              options.stackCommit
+            , options.stackReserve
+            , FIBER_FLAG_FLOAT_SWITCH
+            , &fiberMain
+            , created.get()
+        );
+        if(!created->fiber)
+        {
+            return OccurredError{};
+        }
+        workers.push_back(std::move(created));
+        return workers.back().get();
+    }
+
+    void retire(Worker* const worker)
+    {
+        if(idle.size() < options.pooledFibers)
+        {
+            idle.push_back(worker);
+            return;
+        }
+        ::DeleteFiber(worker->fiber);
+        std::erase_if(workers, [worker](const auto& owned){ return owned.get() == worker; });
+    }
+
+    void runHandedOver()
+    {
+        if(!handOverPending.exchange(false, std::memory_order_acquire))
+        {
+            return;
+        }
+        std::vector<Wake> wakes;
+        {
+            std::lock_guard lock{handOverMutex};
+            wakes.swap(handOver);
+        }
+        for(Wake& wake : wakes)
+        {
+            wake();
+        }
+    }
+
+    Maybe<void> loop()
+    {
+        std::optional<OccurredError> failed;
+        while(readyFirst || (!failed && !tasks.empty()) || 0u != parked)
+        {
+            if(0u != parked)
+            {
+                // fibers which keep yielding or a long backlog must not hold off the wake-ups
+                runQueuedApcs();
+                runHandedOver();
+            }
+
+            if(readyFirst)
+            {
+                active = takeReady();
+            }
+            else if(!failed && !tasks.empty())
+            {
+                auto next = worker();
+                if(!next.okay())
+                {
+                    // parked fibers still have to finish, their waits point into their stacks
+                    failed = next.code();
+                    continue;
+                }
+                active = next.value();
+                active->task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            else
+            {
+                // wake-ups come as APCs or are handed over
+                ::WaitForSingleObjectEx(handedOver.get(), INFINITE, TRUE);
+                continue;
+            }
+
+            ::SwitchToFiber(active->fiber);
+            active = nullptr;
+            for(Worker* const done : finished)
+            {
+                retire(done);
+            }
+            finished.clear();
+        }
+        if(failed)
+        {
+            return Maybe<void>{*failed};
+        }
+        return {};
+    }
+
+    const FiberOptions options;
+    ApcQueue self;
+    Sync::AutoEvent handedOver;     // set when wakes wait in handOver
+    std::atomic<bool> handOverPending{false};
+    std::mutex handOverMutex;
+    std::vector<Wake> handOver;
+    LPVOID mainFiber = nullptr;
+    Worker* active = nullptr;
+    size_t parked = 0u;
+    std::exception_ptr failure;
+
+    std::deque<std::function<void()>> tasks;
+    Worker* readyFirst = nullptr;
+    Worker* readyLast = nullptr;
+    std::vector<Worker*> idle;
+    std::vector<Worker*> finished;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+}; // class FiberScheduler
+
+// Gives the other fibers a turn, nothing outside of a fiber.
+static void yieldFiber()
+{
+    FiberScheduler* const scheduler = FiberScheduler::current();
+    if(scheduler && scheduler->inFiber())
+    {
+        scheduler->yield();
+    }
+}
+
+struct FiberWait
+{
+    FiberScheduler* scheduler = nullptr;
+    FiberScheduler::Wake wake;
+    WaitStatus status = WaitStatus::Timeout;
+};
+
+static void CALLBACK fiberWaitDone(const PVOID parameter, const BOOLEAN timedOut)
+{
+    // on a thread pool thread, the fiber is woken on its own
+    FiberWait& wait = *static_cast<FiberWait*>(parameter);
+    wait.status = timedOut ? WaitStatus::Timeout : WaitStatus::Object0;
+    wait.scheduler->post(std::move(wait.wake)); // never lost, a parked fiber would keep run() from returning
+}
+
+// waitFor which parks the fiber instead of blocking the thread, the wait itself is done
+// by the thread pool. Outside of a fiber it is plain waitFor.
+template<typename C>
+Maybe<WaitStatus> fiberWaitFor(const Handle<C>& handle, const Milliseconds timeout = Infinite)
+{
+    FiberScheduler* const scheduler = FiberScheduler::current();
+    if(!scheduler || !scheduler->inFiber())
+    {
+        return waitFor(handle, timeout);
+    }
+
+    FiberWait wait;
+    wait.scheduler = scheduler;
+    HANDLE registration = nullptr;
+    auto parked = scheduler->park([&](FiberScheduler::Wake wake) -> Maybe<void>
+    {
+        wait.wake = std::move(wake);
+        if(FALSE == ::RegisterWaitForSingleObject
+        (
+              &registration
+            , handle.get()
+            , &fiberWaitDone
+            , &wait
+            , timeout.count()
+            , WT_EXECUTEONLYONCE
+        ))
+        {
+            return OccurredError{};
+        }
+        return {};
+    });
+    if(!parked.okay())
+    {
+        return Maybe<WaitStatus>{parked.code()};
+    }
+    ::UnregisterWaitEx(registration, INVALID_HANDLE_VALUE);
+    return WaitStatus{wait.status};
+}
+
+} // namespace WinApi
@@ -4,6 +4,7 @@
 //
 
 #include <WinApi/Common.h>
+#include <WinApi/Trace.h>
 #include <winnt.h>
 #include <memory>
 #include <Utils/Flag.h>
@@ -37,6 +38,7 @@ Maybe<WaitStatus> waitFor(    const Handle<C>& handle
                             , const Milliseconds timeout = Infinite
                             , const AlertableFlag alertable = !Alertable  )
 {
+    WINAPI_TRACE_SCOPE(trace, "waitFor");
     const DWORD status = ::WaitForSingleObjectEx
     (
           handle.get()
@@ -45,6 +47,7 @@ Maybe<WaitStatus> waitFor(    const Handle<C>& handle
     );
     if(status == WAIT_FAILED)
     {
+        trace.failed();
         return OccurredError{};
     }
     return static_cast<WaitStatus>(status);
@@ -5,6 +5,7 @@
 
 #include <WinApi/Common.h>
 #include <WinApi/Handle.h>
+#include <WinApi/Trace.h>
 #include <heapapi.h>
 #include <Utils/CountOf.h>
 
@@ -94,7 +95,9 @@ auto heapEmplace(const Heap<Flags, T, C>& heap, A&&... args)
         ::HeapFree(heap, 0, instance);
     };
     using Instance = std::unique_ptr<T, decltype(destructor)>;
+    WINAPI_TRACE_SCOPE(trace, "heapEmplace");
     const auto pointer = ::HeapAlloc(heap.handle.get(), 0, static_cast<size_t>(size));
+    trace.bytes(pointer ? static_cast<size_t>(size) : 0u);
 
     if constexpr(Flags & HeapFlags::GenerateExceptions)
     {
@@ -110,6 +113,7 @@ auto heapEmplace(const Heap<Flags, T, C>& heap, A&&... args)
     {
         if(!pointer)
         {
+            trace.failed();
             return Maybe<Instance>{OccurredError{}};
         }
         auto holder = safeHandle(pointer, [heap = heap.handle.get()](void* const pointer)
@@ -0,0 +1,480 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <WinApi/Sync/EventPool.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+struct BlockCacheOptions
+{
+    CountOfBytes blockSize = CountOfBytes{} + OneByte * (4u << 10);
+    size_t blocks = 4096u;      // capacity of the whole cache
+    size_t shards = 16u;        // each with its own lock and clock
+    size_t prefetch = 0u;       // blocks after a missed one which are read on the thread pool
+};
+
+struct BlockCacheStats
+{
+    std::atomic<uint64_t> hits{0u};
+    std::atomic<uint64_t> misses{0u};
+    std::atomic<uint64_t> evictions{0u};
+    std::atomic<uint64_t> coalesced{0u};    // misses which waited for a read already running
+    std::atomic<uint64_t> prefetched{0u};
+};
+
+// Fixed size cache of the blocks of one file, read with fileReadAt. Blocks are spread
+// over shards, every shard evicts with CLOCK: a hit marks the block, the hand clears
+// the marks and takes the first unmarked block which nobody pins. Concurrent misses
+// of one block wait for a single read. Nothing is cached past the end of the file.
+// Open the file with FileFlag::Overllaped, so misses of different blocks and the prefetches
+// read at once, the system runs the reads of a synchronous handle one after another.
+// The file must outlive the cache and must not grow while it is cached.
+template<typename F>
+requires IsFileAllowRead<F>
+class BlockCache
+{
+    struct Frame
+    {
+        uint64_t block = 0u;
+        size_t size = 0u;       // shorter than the block size at the end of the file
+        uint32_t pins = 0u;
+        bool used = false;
+        bool referenced = false;
+        bool loading = false;
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::condition_variable loaded;
+        std::vector<Frame> frames;
+        std::vector<std::byte> memory;
+        std::unordered_map<uint64_t, size_t> index;
+        size_t hand = 0u;
+    };
+
+    static constexpr size_t NoFrame = ~size_t{0};
+
+public:
+    // A block which stays in the cache while the pin is held.
+    class Pin
+    {
+    public:
+        Pin() noexcept = default;
+
+        Pin(Pin&& other) noexcept
+            : shard{std::exchange(other.shard, nullptr)}
+            , frame{other.frame}
+            , bytes{other.bytes}
+        {}
+
+        Pin& operator = (Pin&& other) noexcept
+        {
+            if(this != &other)
+            {
+                release();
+                shard = std::exchange(other.shard, nullptr);
+                frame = other.frame;
+                bytes = other.bytes;
+            }
+            return *this;
+        }
+
+        ~Pin()
+        {
+            release();
+        }
+
+        std::span<const std::byte> data() const noexcept
+        {
+            return bytes;
+        }
+
+        void release() noexcept
+        {
+            if(Shard* const owner = std::exchange(shard, nullptr))
+            {
+                std::lock_guard lock{owner->mutex};
+                --owner->frames[frame].pins;
+            }
+        }
+
+    private:
+        friend class BlockCache;
+
+        Pin(Shard& owner, const size_t pinned, const std::span<const std::byte> pinnedBytes) noexcept
+            : shard{&owner}
+            , frame{pinned}
+            , bytes{pinnedBytes}
+        {}
+
+        Shard* shard = nullptr;
+        size_t frame = 0u;
+        std::span<const std::byte> bytes;
+
+    }; // class Pin
+
+    BlockCache(const F& cachedFile, const BlockCacheOptions& cacheOptions = {})
+        : file{cachedFile}
+        , options{cacheOptions}
+        , blockBytes{std::max<size_t>(static_cast<size_t>(cacheOptions.blockSize), 1u)}
+        , shards(std::max<size_t>(cacheOptions.shards, 1u))
+    {
+        const size_t frames = std::max<size_t>((options.blocks + shards.size() - 1u) / shards.size(), 1u);
+        for(Shard& shard : shards)
+        {
+            shard.frames.resize(frames);
+            shard.memory.resize(frames * blockBytes);
+            shard.index.reserve(frames);
+        }
+    }
+
+    ~BlockCache()
+    {
+        drain();
+    }
+
+    BlockCache(const BlockCache&) = delete;
+    BlockCache& operator = (const BlockCache&) = delete;
+
+    CountOfBytes blockSize() const noexcept
+    {
+        return CountOfBytes{} + OneByte * blockBytes;
+    }
+
+    // ERROR_BUSY when every block of the shard is pinned. Past the end of the file
+    // the pin holds no data, once the cache has seen the end it doesn't read there again.
+    Maybe<Pin> pin(const uint64_t block)
+    {
+        if(block >= endBlock.load(std::memory_order_relaxed))
+        {
+            return Pin{};
+        }
+        Shard& shard = shardOf(block);
+        std::unique_lock lock{shard.mutex};
+        if(auto cached = lookup(shard, block, lock))
+        {
+            cacheStats.hits.fetch_add(1u, std::memory_order_relaxed);
+            return std::move(*cached);
+        }
+        cacheStats.misses.fetch_add(1u, std::memory_order_relaxed);
+        auto loaded = load(shard, block, lock);
+        lock.unlock();
+
+        if(loaded.okay() && loaded.value().data().size() == blockBytes)
+        {
+            prefetchAfter(block);
+        }
+        return std::move(loaded);
+    }
+
+    // fileReadAt through the cache, fewer bytes at the end of the file.
+    Maybe<CountOfBytes> read(const CountOfBytes offset, const std::span<std::byte> buffer)
+    {
+        size_t done = 0u;
+        while(done < buffer.size())
+        {
+            const size_t position = static_cast<size_t>(offset) + done;
+            auto block = pin(position / blockBytes);
+            if(!block.okay())
+            {
+                return Maybe<CountOfBytes>{block.code()};
+            }
+            const auto data = block.value().data();
+            const size_t skip = position % blockBytes;
+            if(data.size() <= skip)
+            {
+                break; // end of file
+            }
+            const size_t copied = std::min(data.size() - skip, buffer.size() - done);
+            std::memcpy(buffer.data() + done, data.data() + skip, copied);
+            done += copied;
+            if(data.size() < blockBytes)
+            {
+                break;
+            }
+        }
+        return CountOfBytes{} + OneByte * done;
+    }
+
+    // Waits for the prefetches still reading.
+    void drain()
+    {
+        std::unique_lock lock{prefetchMutex};
+        prefetchIdle.wait(lock, [this]{ return 0u == prefetching; });
+    }
+
+    const BlockCacheStats& stats() const noexcept
+    {
+        return cacheStats;
+    }
+
+private:
+    Shard& shardOf(const uint64_t block) noexcept
+    {
+        // neighbours land in different shards, so a scan does not contend on one lock
+        return shards[static_cast<size_t>(block % shards.size())];
+    }
+
+    std::span<const std::byte> bytesOf(Shard& shard, const size_t frame) const noexcept
+    {
+        return {shard.memory.data() + frame * blockBytes, shard.frames[frame].size};
+    }
+
+    std::optional<Pin> lookup(Shard& shard, const uint64_t block, std::unique_lock<std::mutex>& lock)
+    {
+        bool waited = false;
+        for(;;)
+        {
+            const auto found = shard.index.find(block);
+            if(found == shard.index.end())
+            {
+                return std::nullopt;
+            }
+            Frame& frame = shard.frames[found->second];
+            if(frame.loading)
+            {
+                if(!waited)
+                {
+                    cacheStats.coalesced.fetch_add(1u, std::memory_order_relaxed);
+                    waited = true;
+                }
+                shard.loaded.wait(lock);
+                continue; // the read may have failed and the block gone
+            }
+            frame.referenced = true;
+            ++frame.pins;
+            return Pin{shard, found->second, bytesOf(shard, found->second)};
+        }
+    }
+
+    size_t victim(Shard& shard) noexcept
+    {
+        const size_t frames = shard.frames.size();
+        for(size_t step = 0u; step < 2u * frames; ++step)
+        {
+            const size_t index = shard.hand;
+            shard.hand = (shard.hand + 1u) % frames;
+            Frame& frame = shard.frames[index];
+            if(!frame.used)
+            {
+                return index;
+            }
+            if(0u != frame.pins || frame.loading)
+            {
+                continue;
+            }
+            if(frame.referenced)
+            {
+                frame.referenced = false;
+                continue;
+            }
+            return index;
+        }
+        return NoFrame;
+    }
+
+    // Claims a frame for the block, others asking for the block meanwhile wait in lookup.
+    size_t claim(Shard& shard, const uint64_t block, const uint32_t pins)
+    {
+        const size_t index = victim(shard);
+        if(NoFrame == index)
+        {
+            return NoFrame;
+        }
+        Frame& frame = shard.frames[index];
+        if(frame.used)
+        {
+            shard.index.erase(frame.block);
+            cacheStats.evictions.fetch_add(1u, std::memory_order_relaxed);
+        }
+        frame = Frame{block, 0u, pins, true, false, true};
+        shard.index.emplace(block, index);
+        return index;
+    }
+
+    // Reads a claimed frame, without holding the lock.
+    Maybe<CountOfBytes> readFrame(Shard& shard, const size_t index, const uint64_t block)
+    {
+        auto completion = events.acquire();
+        if(!completion.okay())
+        {
+            return Maybe<CountOfBytes>{completion.code()};
+        }
+        std::byte* const data = shard.memory.data() + index * blockBytes;
+        return fileReadAtOverlapped(  file
+                                    , CountOfBytes{} + OneByte * (block * blockBytes)
+                                    , data
+                                    , data + blockBytes
+                                    , completion.value().get().get() );
+    }
+
+    // Ends the load of a claimed frame. A failed read, or one past the end of the file,
+    // gives the frame back and caches nothing.
+    bool publish(Shard& shard, const size_t index, const uint64_t block, const Maybe<CountOfBytes>& read)
+    {
+        const size_t size = read.okay() ? static_cast<size_t>(read.value()) : 0u;
+        if(read.okay() && size < blockBytes)
+        {
+            endsAt(0u == size ? block : block + 1u);
+        }
+        if(0u == size)
+        {
+            abandon(shard, index, block);
+            return false;
+        }
+        Frame& frame = shard.frames[index];
+        frame.loading = false;
+        frame.size = size;
+        shard.loaded.notify_all();
+        return true;
+    }
+
+    void abandon(Shard& shard, const size_t index, const uint64_t block)
+    {
+        shard.index.erase(block);
+        shard.frames[index] = Frame{};
+        shard.loaded.notify_all();
+    }
+
+    Maybe<Pin> load(Shard& shard, const uint64_t block, std::unique_lock<std::mutex>& lock)
+    {
+        const size_t index = claim(shard, block, 1u);
+        if(NoFrame == index)
+        {
+            ::SetLastError(ERROR_BUSY);
+            return OccurredError{};
+        }
+        lock.unlock();
+        auto read = readFrame(shard, index, block);
+        lock.lock();
+
+        if(!publish(shard, index, block, read))
+        {
+            if(!read.okay())
+            {
+                return Maybe<Pin>{read.code()};
+            }
+            return Pin{};
+        }
+        return Pin{shard, index, bytesOf(shard, index)};
+    }
+
+    void endsAt(const uint64_t block) noexcept
+    {
+        uint64_t known = endBlock.load(std::memory_order_relaxed);
+        while(block < known && !endBlock.compare_exchange_weak(known, block, std::memory_order_relaxed))
+        {}
+    }
+
+    struct Prefetch
+    {
+        BlockCache* cache = nullptr;
+        Shard* shard = nullptr;
+        size_t frame = 0u;
+        uint64_t block = 0u;
+    };
+
+    // Claims frames for the blocks after `block` and reads them on the thread pool,
+    // the miss which asked for them does not wait.
+    void prefetchAfter(const uint64_t block)
+    {
+        for(uint64_t next = block + 1u; next <= block + options.prefetch; ++next)
+        {
+            if(next >= endBlock.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            Shard& shard = shardOf(next);
+            std::unique_lock lock{shard.mutex};
+            if(shard.index.contains(next))
+            {
+                continue;
+            }
+            const size_t index = claim(shard, next, 0u);
+            if(NoFrame == index)
+            {
+                return;
+            }
+            lock.unlock();
+            if(!startPrefetch(Prefetch{this, &shard, index, next}))
+            {
+                lock.lock();
+                abandon(shard, index, next);
+                return;
+            }
+        }
+    }
+
+    bool startPrefetch(const Prefetch& request)
+    {
+        auto owned = std::make_unique<Prefetch>(request);
+        {
+            std::lock_guard lock{prefetchMutex};
+            ++prefetching;
+        }
+        if(FALSE == ::TrySubmitThreadpoolCallback(&prefetch, owned.get(), nullptr))
+        {
+            prefetchDone();
+            return false;
+        }
+        owned.release(); // prefetch owns it now
+        return true;
+    }
+
+    static void CALLBACK prefetch(PTP_CALLBACK_INSTANCE, const PVOID parameter)
+    {
+        const std::unique_ptr<Prefetch> request{static_cast<Prefetch*>(parameter)};
+        BlockCache& cache = *request->cache;
+        Shard& shard = *request->shard;
+        auto read = cache.readFrame(shard, request->frame, request->block);
+        {
+            std::lock_guard lock{shard.mutex};
+            if(cache.publish(shard, request->frame, request->block, read))
+            {
+                cache.cacheStats.prefetched.fetch_add(1u, std::memory_order_relaxed);
+            }
+        }
+        cache.prefetchDone();
+    }
+
+    void prefetchDone()
+    {
+        std::lock_guard lock{prefetchMutex};
+        if(0u == --prefetching)
+        {
+            prefetchIdle.notify_all();
+        }
+    }
+
+    const F& file;
+    const BlockCacheOptions options;
+    const size_t blockBytes;
+    std::vector<Shard> shards;
+    Sync::ManualEventPool events;   // one per read in flight
+    BlockCacheStats cacheStats;
+    std::atomic<uint64_t> endBlock{~uint64_t{0}};  // first block known to be past the end of the file
+
+    std::mutex prefetchMutex;
+    std::condition_variable prefetchIdle;
+    size_t prefetching = 0u;
+
+}; // class BlockCache
+
+} // namespace WinApi::IO
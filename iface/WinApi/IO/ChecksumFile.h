@@ -0,0 +1,71 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <Utils/Checksum.h>
+#include <span>
+
+
+namespace WinApi::IO
+{
+
+using Utils::IsHasher;
+using Utils::Crc32c;
+using Utils::XxHash64;
+
+template<typename I, typename D>
+struct Checked
+{
+    CountOf<I> count;
+    D digest;   // running digest of everything passed through the hasher so far
+};
+
+// fileRead which feeds the bytes to `hasher` while they are still hot in the cache,
+// so verifying a file costs no second pass over memory. Every byte read is hashed,
+// also those of a partial element at the end of the file, which `count` leaves out.
+template<typename Handle, typename I, typename H>
+requires IsFileAllowRead<Handle> && std::is_trivially_copyable_v<I> && IsHasher<H>
+Checked<I, typename H::Digest> fileReadChecked(  const Handle& file
+                                               , I * const buffer_begin
+                                               , const I * const buffer_end
+                                               , H& hasher )
+{
+    const auto begin = reinterpret_cast<std::byte * >(buffer_begin);
+    const auto end   = reinterpret_cast<const std::byte * >(buffer_end);
+    const CountOfBytes read = fileRead(file, begin, end);
+    hasher.update(std::span<const std::byte>{begin, static_cast<size_t>(read)});
+    return {Utils::countOf<I>(read), hasher.digest()};
+}
+
+template<typename Handle, typename C, typename H>
+auto fileReadDataChecked(const Handle& file, C& container, H& hasher)
+{
+    const auto begin = std::data(container);
+    const auto end = begin + std::size(container);
+    return fileReadChecked(file, begin, end, hasher);
+}
+
+// Only the bytes which were actually written are hashed.
+template<typename F, typename I, typename H>
+requires IsFileAllowWrite<F> && std::is_trivially_copyable_v<I> && IsHasher<H>
+Checked<I, typename H::Digest> fileWriteChecked(  const F& file
+                                                , const I * const buffer_begin
+                                                , const I * const buffer_end
+                                                , H& hasher )
+{
+    const CountOf<I> written = fileWrite(file, buffer_begin, buffer_end);
+    hasher.update(std::as_bytes(std::span{buffer_begin, static_cast<size_t>(written)}));
+    return {written, hasher.digest()};
+}
+
+template<typename F, typename C, typename H>
+auto fileWriteDataChecked(const F& file, const C& container, H& hasher)
+{
+    const auto begin = std::data(container);
+    const auto end = begin + std::size(container);
+    return fileWriteChecked(file, begin, end, hasher);
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,293 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <WinApi/Thread.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+struct DirectoryEntry
+{
+    std::wstring name;
+    DWORD        attributes = 0u;
+    CountOfBytes size;
+    FILETIME     lastWriteTime{};
+
+    bool isDirectory() const noexcept
+    {
+        return 0u != (attributes & FILE_ATTRIBUTE_DIRECTORY);
+    }
+
+    bool isReparsePoint() const noexcept
+    {
+        return 0u != (attributes & FILE_ATTRIBUTE_REPARSE_POINT);
+    }
+};
+
+template<typename C>
+struct DirectoryReader
+{
+    Handle<C> handle;
+    WIN32_FIND_DATAW next{};
+    bool pending = true;
+};
+
+// FindFirstFileEx with the basic info level (no short names) and large fetch,
+// so every FindNextFile is served from a big kernel buffer.
+static auto openDirectory(const std::filesystem::path& path)
+{
+    WINAPI_TRACE_SCOPE(trace, "openDirectory");
+    WIN32_FIND_DATAW first{};
+    const HANDLE handle = ::FindFirstFileExW
+    (
+          (path / "*").c_str()
+        , FindExInfoBasic
+        , &first
+        , FindExSearchNameMatch
+        , nullptr
+        , FIND_FIRST_EX_LARGE_FETCH
+    );
+
+    auto close = [](const HANDLE handle)
+    {
+        ::FindClose(handle);
+    };
+    using Reader = DirectoryReader<decltype(close)>;
+
+    if(handle == INVALID_HANDLE_VALUE)
+    {
+        trace.failed();
+        return Maybe<Reader>{OccurredError{}};
+    }
+    return Maybe<Reader>{Reader{{handle, std::move(close)}, first}};
+}
+
+using MaybeDirectory = decltype(openDirectory(std::filesystem::path{}));
+using Directory = typename MaybeDirectory::Type;
+
+// Replaces the content of `batch` with up to `maxEntries` next entries, "." and ".." excluded.
+// An empty batch means the enumeration is complete.
+static Maybe<CountOf<DirectoryEntry>> directoryRead(  Directory& directory
+                                                    , std::vector<DirectoryEntry>& batch
+                                                    , const size_t maxEntries = 4096u )
+{
+    WINAPI_TRACE_SCOPE(trace, "directoryRead");
+    batch.clear();
+    while(batch.size() < maxEntries)
+    {
+        if(!directory.pending)
+        {
+            if(FALSE == ::FindNextFileW(directory.handle.get(), &directory.next))
+            {
+                if(::GetLastError() != ERROR_NO_MORE_FILES)
+                {
+                    trace.failed();
+                    return OccurredError{};
+                }
+                break;
+            }
+        }
+        directory.pending = false;
+
+        const WIN32_FIND_DATAW& found = directory.next;
+        const std::wstring_view name{found.cFileName};
+        if(name == L"." || name == L"..")
+        {
+            continue;
+        }
+        const ULONGLONG size = (ULONGLONG{found.nFileSizeHigh} << 32) | found.nFileSizeLow;
+        batch.push_back(DirectoryEntry
+        {
+              .name          = std::wstring{name}
+            , .attributes    = found.dwFileAttributes
+            , .size          = CountOfBytes{} + OneByte * size
+            , .lastWriteTime = found.ftLastWriteTime
+        });
+    }
+    return Utils::countOf(batch);
+}
+
+
+using DirectoryVisitor = std::function<void(  const std::filesystem::path& directory
+                                            , std::span<const DirectoryEntry> batch )>;
+
+using DirectoryErrorHandler = std::function<void(const std::filesystem::path& directory, OccurredError error)>;
+
+// Walks the tree below `root` on `workers` threads, each subdirectory found is queued
+// for whichever worker is free. `visit` is called concurrently, once per batch.
+// Reparse points are not followed. Subdirectories which can't be opened or read to the end
+// are passed to `onError`, also called concurrently, and the walk goes on without them.
+// The first exception `visit` or `onError` throws stops the walk and is rethrown once
+// all workers have stopped.
+static Maybe<void> walkDirectory(  const std::filesystem::path& root
+                                 , const DirectoryVisitor& visit
+                                 , const size_t workers = std::thread::hardware_concurrency()
+                                 , const size_t batchSize = 4096u
+                                 , const WorkerStart& onWorkerStart = {}
+                                 , const DirectoryErrorHandler& onError = {} )
+{
+    auto rootDirectory = openDirectory(root);
+    if(!rootDirectory.okay())
+    {
+        return Maybe<void>{rootDirectory.code()};
+    }
+
+    struct Pending
+    {
+        std::filesystem::path path;
+        std::optional<Directory> directory;
+    };
+
+    struct Shared
+    {
+        std::mutex guard;
+        std::condition_variable changed;
+        std::deque<Pending> queue;
+        size_t busy = 0u;
+        std::exception_ptr failure;     // the first exception thrown, stops the walk
+    } shared;
+    shared.queue.push_back(Pending{root, std::move(rootDirectory).value()});
+
+    // Done with a directory however its walk was left.
+    struct Visiting
+    {
+        explicit Visiting(Shared& walk) noexcept
+            : state{walk}
+        {}
+
+        ~Visiting()
+        {
+            std::lock_guard lock{state.guard};
+            --state.busy;
+            state.changed.notify_all();
+        }
+
+        Shared& state;
+    };
+
+    auto walk = [&](const size_t worker)
+    {
+        std::optional<ThreadStateRestore> restore;
+        if(onWorkerStart)
+        {
+            if(0u == worker)
+            {
+                restore.emplace(); // the caller's own thread
+            }
+            onWorkerStart(worker);
+        }
+        std::vector<DirectoryEntry> batch;
+        std::vector<std::filesystem::path> found;
+        for(;;)
+        {
+            Pending next;
+            {
+                std::unique_lock lock{shared.guard};
+                shared.changed.wait(lock, [&]{ return shared.failure || !shared.queue.empty() || 0u == shared.busy; });
+                if(shared.failure || shared.queue.empty())
+                {
+                    return;
+                }
+                next = std::move(shared.queue.front());
+                shared.queue.pop_front();
+                ++shared.busy;
+            }
+            const Visiting visiting{shared};
+
+            if(!next.directory)
+            {
+                auto opened = openDirectory(next.path);
+                if(!opened.okay())
+                {
+                    if(onError)
+                    {
+                        onError(next.path, opened.code());
+                    }
+                    continue;
+                }
+                next.directory.emplace(std::move(opened).value());
+            }
+
+            for(;;)
+            {
+                const auto read = directoryRead(*next.directory, batch, batchSize);
+                if(!read.okay())
+                {
+                    if(onError)
+                    {
+                        onError(next.path, read.code());
+                    }
+                    break;
+                }
+                if(batch.empty())
+                {
+                    break;
+                }
+                found.clear();
+                for(const DirectoryEntry& entry : batch)
+                {
+                    if(entry.isDirectory() && !entry.isReparsePoint())
+                    {
+                        found.push_back(next.path / entry.name);
+                    }
+                }
+                if(!found.empty())
+                {
+                    std::lock_guard lock{shared.guard};
+                    for(auto& path : found)
+                    {
+                        shared.queue.push_back(Pending{std::move(path), std::nullopt});
+                    }
+                    shared.changed.notify_all();
+                }
+                visit(next.path, batch);
+            }
+        }
+    };
+
+    auto work = [&](const size_t worker)
+    {
+        try
+        {
+            walk(worker);
+        }
+        catch(...)
+        {
+            std::lock_guard lock{shared.guard};
+            if(!shared.failure)
+            {
+                shared.failure = std::current_exception();
+            }
+            shared.changed.notify_all();
+        }
+    };
+
+    std::vector<std::jthread> threads;
+    for(size_t index = 1u; index < std::max<size_t>(workers, 1u); ++index)
+    {
+        threads.emplace_back(work, index);
+    }
+    work(0u);
+    threads.clear();
+    if(shared.failure)
+    {
+        std::rethrow_exception(shared.failure);
+    }
+    return {};
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,306 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <WinApi/IO/FileInfo.h>
+#include <WinApi/Sync/Event.h>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+struct ChangeFlag
+{
+    using Type = DWORD;
+    static constexpr auto FileName   = Flag<FILE_NOTIFY_CHANGE_FILE_NAME  , ChangeFlag>{};
+    static constexpr auto DirName    = Flag<FILE_NOTIFY_CHANGE_DIR_NAME   , ChangeFlag>{};
+    static constexpr auto Attributes = Flag<FILE_NOTIFY_CHANGE_ATTRIBUTES , ChangeFlag>{};
+    static constexpr auto Size       = Flag<FILE_NOTIFY_CHANGE_SIZE       , ChangeFlag>{};
+    static constexpr auto LastWrite  = Flag<FILE_NOTIFY_CHANGE_LAST_WRITE , ChangeFlag>{};
+    static constexpr auto Creation   = Flag<FILE_NOTIFY_CHANGE_CREATION   , ChangeFlag>{};
+    static constexpr auto Security   = Flag<FILE_NOTIFY_CHANGE_SECURITY   , ChangeFlag>{};
+};
+using ChangeMask = Mask<ChangeFlag>;
+
+enum class ChangeAction: DWORD
+{
+      Created  = FILE_ACTION_ADDED
+    , Deleted  = FILE_ACTION_REMOVED
+    , Modified = FILE_ACTION_MODIFIED
+    , Renamed  = FILE_ACTION_RENAMED_NEW_NAME
+};
+
+struct DirectoryChange
+{
+    ChangeAction action = ChangeAction::Modified;
+    std::filesystem::path path;         // watched directory joined with the changed name
+    std::filesystem::path oldPath;      // Renamed only
+};
+
+struct ChangeBatch
+{
+    std::vector<DirectoryChange> changes;
+    bool overflow = false;              // changes were lost, rescan the directory
+};
+
+// Watches a directory with an overlapped ReadDirectoryChangesW which is always pending.
+// event() is signaled when a batch is ready, so it can be waited for along with other
+// handles, readChanges() then takes the batch and issues the next read.
+class DirectoryWatcher
+{
+    struct State
+    {
+        std::filesystem::path directory;
+        bool recursive = false;
+        DWORD filter = 0u;
+        std::vector<DWORD> buffer;      // DWORD aligned as FILE_NOTIFY_INFORMATION requires
+        OVERLAPPED overlapped{};
+        Sync::ManualEvent event;
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        bool pending = false;
+
+        ~State()
+        {
+            if(pending)
+            {
+                // the kernel writes into buffer until the read is really gone
+                DWORD bytes = 0u;
+                ::CancelIoEx(handle, &overlapped);
+                ::GetOverlappedResult(handle, &overlapped, &bytes, TRUE);
+            }
+            if(handle != INVALID_HANDLE_VALUE)
+            {
+                ::CloseHandle(handle);
+            }
+        }
+    };
+
+public:
+    static constexpr size_t DefaultBufferSize = 64u << 10; // larger buffers are refused for network shares
+
+    static Maybe<DirectoryWatcher> create(  const std::filesystem::path& directory
+                                          , const bool recursive = false
+                                          , const ChangeMask filter = ChangeFlag::FileName
+                                                                    | ChangeFlag::DirName
+                                                                    | ChangeFlag::Size
+                                                                    | ChangeFlag::LastWrite
+                                          , const size_t bufferSize = DefaultBufferSize )
+    {
+        WINAPI_TRACE_SCOPE(trace, "createDirectoryWatcher");
+        auto event = Sync::createManualEvent();
+        if(!event.okay())
+        {
+            trace.failed();
+            return Maybe<DirectoryWatcher>{event.code()};
+        }
+
+        auto state = std::make_unique<State>();
+        state->directory = directory;
+        state->recursive = recursive;
+        state->filter = static_cast<DWORD>(filter);
+        state->buffer.resize((bufferSize + sizeof(DWORD) - 1u) / sizeof(DWORD));
+        state->event = std::move(event).value();
+        state->overlapped.hEvent = state->event.get();
+
+        state->handle = ::CreateFileW
+        (
+              directory.c_str()
+            , FILE_LIST_DIRECTORY
+            , FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE
+            , NULL
+            , OPEN_EXISTING
+            , FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED
+            , NULL
+        );
+        if(state->handle == INVALID_HANDLE_VALUE)
+        {
+            trace.failed();
+            return OccurredError{};
+        }
+
+        DirectoryWatcher watcher{std::move(state)};
+        auto issued = watcher.issueRead();
+        if(!issued.okay())
+        {
+            trace.failed();
+            return Maybe<DirectoryWatcher>{issued.code()};
+        }
+        return std::move(watcher);
+    }
+
+    DirectoryWatcher() noexcept = default;
+
+    const std::filesystem::path& directory() const noexcept
+    {
+        return state->directory;
+    }
+
+    const Sync::ManualEvent& event() const noexcept
+    {
+        return state->event;
+    }
+
+    // An empty batch when nothing has changed yet. When the read could not be issued
+    // again the error is returned and the next call retries it, reporting an overflow
+    // since changes may have been missed meanwhile.
+    Maybe<ChangeBatch> readChanges()
+    {
+        DWORD bytes = 0u;
+        ChangeBatch batch;
+        if(!state->pending)
+        {
+            auto issued = issueRead();
+            if(!issued.okay())
+            {
+                return Maybe<ChangeBatch>{issued.code()};
+            }
+            batch.overflow = true;
+            return std::move(batch);
+        }
+        if(FALSE == ::GetOverlappedResult(state->handle, &state->overlapped, &bytes, FALSE))
+        {
+            switch(::GetLastError())
+            {
+            case ERROR_IO_INCOMPLETE:
+                return std::move(batch);
+            case ERROR_NOTIFY_ENUM_DIR:
+                batch.overflow = true;
+                break;
+            default:
+                return OccurredError{};
+            }
+        }
+        else if(0u == bytes)
+        {
+            batch.overflow = true; // the buffer was too small for what happened
+        }
+        else
+        {
+            parse(bytes, batch);
+        }
+
+        auto issued = issueRead();
+        if(!issued.okay())
+        {
+            return Maybe<ChangeBatch>{issued.code()};
+        }
+        return std::move(batch);
+    }
+
+    // Blocks until a batch is ready or the timeout expires, then returns it.
+    Maybe<ChangeBatch> waitChanges(const Milliseconds timeout = Infinite)
+    {
+        if(!state->pending)
+        {
+            return readChanges();
+        }
+        const auto status = waitFor(state->event, timeout);
+        if(!status.okay())
+        {
+            return Maybe<ChangeBatch>{status.code()};
+        }
+        return readChanges();
+    }
+
+private:
+    explicit DirectoryWatcher(std::unique_ptr<State>&& watcherState) noexcept
+        : state{std::move(watcherState)}
+    {}
+
+    Maybe<void> issueRead()
+    {
+        state->pending = false;
+        state->overlapped = OVERLAPPED{};   // the completed read is consumed
+        state->overlapped.hEvent = state->event.get();
+        Sync::resetEvent(state->event);
+        if(FALSE == ::ReadDirectoryChangesW
+        (
+              state->handle
+            , state->buffer.data()
+            , static_cast<DWORD>(state->buffer.size() * sizeof(DWORD))
+            , state->recursive ? TRUE : FALSE
+            , state->filter
+            , nullptr
+            , &state->overlapped
+            , nullptr
+        ))
+        {
+            return OccurredError{};
+        }
+        state->pending = true;
+        return {};
+    }
+
+    void parse(const DWORD bytes, ChangeBatch& batch) const
+    {
+        const auto* const begin = reinterpret_cast<const std::byte*>(state->buffer.data());
+        std::filesystem::path renamedFrom;
+        for(size_t offset = 0u; offset < bytes;)
+        {
+            const auto& info = *reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(begin + offset);
+            const std::wstring_view name{info.FileName, info.FileNameLength / sizeof(WCHAR)};
+            if(FILE_ACTION_RENAMED_NEW_NAME != info.Action)
+            {
+                movedOut(renamedFrom, batch);
+            }
+            switch(info.Action)
+            {
+            case FILE_ACTION_RENAMED_OLD_NAME:
+                renamedFrom = state->directory / name;
+                break;
+            case FILE_ACTION_RENAMED_NEW_NAME:
+                batch.changes.push_back(DirectoryChange{ChangeAction::Renamed, state->directory / name, std::move(renamedFrom)});
+                renamedFrom.clear();
+                break;
+            default:
+                batch.changes.push_back(DirectoryChange{static_cast<ChangeAction>(info.Action), state->directory / name});
+                break;
+            }
+            if(0u == info.NextEntryOffset)
+            {
+                break;
+            }
+            offset += info.NextEntryOffset;
+        }
+        movedOut(renamedFrom, batch);
+    }
+
+    // An old name which no new name follows was moved out of the watched tree.
+    static void movedOut(std::filesystem::path& renamedFrom, ChangeBatch& batch)
+    {
+        if(!renamedFrom.empty())
+        {
+            batch.changes.push_back(DirectoryChange{ChangeAction::Deleted, std::move(renamedFrom)});
+            renamedFrom.clear();
+        }
+    }
+
+    std::unique_ptr<State> state;
+
+}; // class DirectoryWatcher
+
+// Drops what the batch has touched from the cache, everything after an overflow.
+// The cache matches the reported paths whatever spelling its entries were got by.
+static void invalidateChanged(FileInfoCache& cache, const ChangeBatch& batch)
+{
+    if(batch.overflow)
+    {
+        cache.invalidateAll();
+        return;
+    }
+    for(const DirectoryChange& change : batch.changes)
+    {
+        cache.invalidate(change.path);
+        if(!change.oldPath.empty())
+        {
+            cache.invalidate(change.oldPath);
+        }
+    }
+}
+
+} // namespace WinApi::IO
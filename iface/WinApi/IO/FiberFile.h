@@ -0,0 +1,75 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Fiber.h>
+#include <WinApi/IO/FileApc.h>
+#include <optional>
+
+
+namespace WinApi::IO
+{
+
+// Issues the request and parks the fiber until its completion routine has run.
+// Outside of a fiber the thread waits alertably instead.
+template<typename Issue>
+Maybe<CountOfBytes> fiberTransfer(Issue&& issue)
+{
+    std::optional<Maybe<CountOfBytes>> result;
+    FiberScheduler* const scheduler = FiberScheduler::current();
+    if(!scheduler || !scheduler->inFiber())
+    {
+        auto issued = issue([&result](Maybe<CountOfBytes> transferred)
+        {
+            result.emplace(std::move(transferred));
+        });
+        if(!issued.okay())
+        {
+            return Maybe<CountOfBytes>{issued.code()};
+        }
+        while(!result)
+        {
+            ::SleepEx(INFINITE, TRUE);
+        }
+        return std::move(*result);
+    }
+
+    auto parked = scheduler->park([&](FiberScheduler::Wake wake)
+    {
+        return issue([&result, wake = std::move(wake)](Maybe<CountOfBytes> transferred)
+        {
+            result.emplace(std::move(transferred));
+            wake();
+        });
+    });
+    if(!parked.okay())
+    {
+        return Maybe<CountOfBytes>{parked.code()};
+    }
+    return std::move(*result);
+}
+
+// fileReadAt for files opened with FileFlag::Overllaped which parks the fiber
+// instead of blocking the thread. Reads at most MAXDWORD bytes.
+template<typename F>
+requires IsFileAllowRead<F>
+Maybe<CountOfBytes> fiberReadAt(const F& file, const CountOfBytes offset, const std::span<std::byte> buffer)
+{
+    return fiberTransfer([&](IoCompletion onComplete)
+    {
+        return fileReadAsync(file, offset, buffer, std::move(onComplete));
+    });
+}
+
+template<typename F>
+requires IsFileAllowWrite<F>
+Maybe<CountOfBytes> fiberWriteAt(const F& file, const CountOfBytes offset, const std::span<const std::byte> buffer)
+{
+    return fiberTransfer([&](IoCompletion onComplete)
+    {
+        return fileWriteAsync(file, offset, buffer, std::move(onComplete));
+    });
+}
+
+} // namespace WinApi::IO
@@ -4,6 +4,7 @@
 //
 
 #include <type_traits>
+#include <algorithm>
 #include <filesystem>
 #include <optional>
 #include <WinApi/Handle.h>
@@ -84,6 +85,7 @@ auto createFile(  const std::filesystem::path & path
                 , const CreateMode creationDisposition
                 , const FileMask   flags )
 {
+    WINAPI_TRACE_SCOPE(trace, "createFile");
     const HANDLE handle = ::CreateFileW
     (
           path.c_str()
@@ -103,6 +105,7 @@ auto createFile(  const std::filesystem::path & path
     
     if(handle == INVALID_HANDLE_VALUE)
     {
+        trace.failed();
         return Maybe<FileHandle>{OccurredError{}};
     }
     return Maybe<FileHandle>{FileHandle{handle, std::move(close)}};
@@ -182,6 +185,17 @@ void closeFile(F& file) requires IsItFile<F>
     file = nullptr;
 }
 
+struct FileRange
+{
+    CountOfBytes begin;
+    CountOfBytes size;
+
+    constexpr CountOfBytes end() const noexcept
+    {
+        return begin + (size - CountOfBytes{});
+    }
+};
+
 
 enum class FilePointerFrom: DWORD
 {
@@ -232,11 +246,24 @@ Maybe<void> setFilePointerToEnd(const F& file)
     return static_cast<bool>(setFilePointer(file, OffsetOfBytes{}, FilePointerFrom::End));
 }
 
+template<typename F>
+requires IsItFile<F>
+Maybe<CountOfBytes> getFileSize(const F& file)
+{
+    LARGE_INTEGER size{};
+    if(FALSE == ::GetFileSizeEx(file.get(), &size))
+    {
+        return OccurredError{};
+    }
+    return CountOfBytes{} + OneByte * size.QuadPart;
+}
+
 
 template<typename Handle, typename I>
 requires IsFileAllowRead<Handle> && std::is_trivially_copyable_v<I>
 CountOf<I> fileRead(const Handle& file, I * const buffer_begin, const I * const buffer_end)
 {
+    WINAPI_TRACE_SCOPE(trace, "fileRead");
     CountOfBytes totalBytes{};
     const auto begin = reinterpret_cast<std::byte * >(buffer_begin);
     const auto end   = reinterpret_cast<const std::byte * >(buffer_end);
@@ -262,9 +289,11 @@ CountOf<I> fileRead(const Handle& file, I * const buffer_begin, const I * const
 
         if(!succedded)
         {
+            trace.failed();
             break;
         }
     }
+    trace.bytes(static_cast<size_t>(totalBytes));
     return Utils::countOf<I>(totalBytes);
 }
 
@@ -297,6 +326,7 @@ template<typename F, typename I>
 requires IsFileAllowWrite<F> && std::is_trivially_copyable_v<I>
 CountOf<I> fileWrite(const F& file, const I * const buffer_begin, const I * const buffer_end)
 {
+    WINAPI_TRACE_SCOPE(trace, "fileWrite");
     CountOfBytes totalBytes;
     const auto begin = reinterpret_cast<const std::byte * >(buffer_begin);
     const auto end   = reinterpret_cast<const std::byte * >(buffer_end);
@@ -316,9 +346,11 @@ CountOf<I> fileWrite(const F& file, const I * const buffer_begin, const I * cons
 
         if(!succedded)
         {
+            trace.failed();
             break;
         }
     }
+    trace.bytes(static_cast<size_t>(totalBytes));
     return Utils::countOf<I>(totalBytes);
 }
 
@@ -347,4 +379,147 @@ auto fileWriteData(const Handle& file, const C& container)
 }
 
 
+// Positional I/O: every call carries its own offset, so threads may share one handle
+// without racing on the file pointer.
+static OVERLAPPED filePosition(const CountOfBytes position) noexcept
+{
+    const ULARGE_INTEGER offset{.QuadPart = static_cast<size_t>(position)};
+    OVERLAPPED overlapped{};
+    overlapped.Offset     = offset.LowPart;
+    overlapped.OffsetHigh = offset.HighPart;
+    return overlapped;
+}
+
+template<typename Handle, typename I>
+requires IsFileAllowRead<Handle> && std::is_trivially_copyable_v<I>
+Maybe<CountOf<I>> fileReadAt(   const Handle& file
+                              , const CountOfBytes offset
+                              , I * const buffer_begin
+                              , const I * const buffer_end )
+{
+    WINAPI_TRACE_SCOPE(trace, "fileReadAt");
+    CountOfBytes totalBytes{};
+    const auto begin = reinterpret_cast<std::byte * >(buffer_begin);
+    const auto end   = reinterpret_cast<const std::byte * >(buffer_end);
+    for(std::byte * cursor = begin; cursor < end;)
+    {
+        OVERLAPPED overlapped = filePosition(offset + (totalBytes - CountOfBytes{}));
+        DWORD actuallyRead = 0u;
+        const BOOL succedded = ::ReadFile
+        (
+              file.get()
+            , reinterpret_cast<void * >(cursor)
+            , static_cast<DWORD>(std::min<ptrdiff_t>(end - cursor, MAXDWORD))
+            , &actuallyRead
+            , &overlapped
+        );
+        if(!succedded)
+        {
+            if(::GetLastError() == ERROR_HANDLE_EOF)
+            {
+                break;
+            }
+            trace.failed();
+            return OccurredError{};
+        }
+        if(0u == actuallyRead)
+        {
+            break; // end of file
+        }
+        cursor += actuallyRead;
+        totalBytes += OneByte * actuallyRead;
+    }
+    trace.bytes(static_cast<size_t>(totalBytes));
+    return Utils::countOf<I>(totalBytes);
+}
+
+// fileReadAt which also reads FileFlag::Overllaped handles: a pending read is waited for
+// on `completion`, a manual reset event of the caller. Threads sharing an overlapped handle
+// have their reads in flight at once, the system runs the reads of a synchronous handle
+// one after another.
+template<typename Handle, typename I>
+requires IsFileAllowRead<Handle> && std::is_trivially_copyable_v<I>
+Maybe<CountOf<I>> fileReadAtOverlapped(  const Handle& file
+                                       , const CountOfBytes offset
+                                       , I * const buffer_begin
+                                       , const I * const buffer_end
+                                       , const HANDLE completion )
+{
+    WINAPI_TRACE_SCOPE(trace, "fileReadAt");
+    CountOfBytes totalBytes{};
+    const auto begin = reinterpret_cast<std::byte * >(buffer_begin);
+    const auto end   = reinterpret_cast<const std::byte * >(buffer_end);
+    for(std::byte * cursor = begin; cursor < end;)
+    {
+        OVERLAPPED overlapped = filePosition(offset + (totalBytes - CountOfBytes{}));
+        overlapped.hEvent = completion;
+        DWORD actuallyRead = 0u;
+        BOOL succedded = ::ReadFile
+        (
+              file.get()
+            , reinterpret_cast<void * >(cursor)
+            , static_cast<DWORD>(std::min<ptrdiff_t>(end - cursor, MAXDWORD))
+            , &actuallyRead
+            , &overlapped
+        );
+        if(!succedded && ::GetLastError() == ERROR_IO_PENDING)
+        {
+            succedded = ::GetOverlappedResult(file.get(), &overlapped, &actuallyRead, TRUE);
+        }
+        if(!succedded)
+        {
+            if(::GetLastError() == ERROR_HANDLE_EOF)
+            {
+                break;
+            }
+            trace.failed();
+            return OccurredError{};
+        }
+        if(0u == actuallyRead)
+        {
+            break; // end of file
+        }
+        cursor += actuallyRead;
+        totalBytes += OneByte * actuallyRead;
+    }
+    trace.bytes(static_cast<size_t>(totalBytes));
+    return Utils::countOf<I>(totalBytes);
+}
+
+template<typename F, typename I>
+requires IsFileAllowWrite<F> && std::is_trivially_copyable_v<I>
+Maybe<CountOf<I>> fileWriteAt(  const F& file
+                              , const CountOfBytes offset
+                              , const I * const buffer_begin
+                              , const I * const buffer_end )
+{
+    WINAPI_TRACE_SCOPE(trace, "fileWriteAt");
+    CountOfBytes totalBytes{};
+    const auto begin = reinterpret_cast<const std::byte * >(buffer_begin);
+    const auto end   = reinterpret_cast<const std::byte * >(buffer_end);
+    for(const std::byte * cursor = begin; cursor < end;)
+    {
+        OVERLAPPED overlapped = filePosition(offset + (totalBytes - CountOfBytes{}));
+        DWORD written = 0u;
+        const BOOL succedded = ::WriteFile
+        (
+              file.get()
+            , reinterpret_cast<const void * >(cursor)
+            , static_cast<DWORD>(std::min<ptrdiff_t>(end - cursor, MAXDWORD))
+            , &written
+            , &overlapped
+        );
+        if(!succedded)
+        {
+            trace.failed();
+            return OccurredError{};
+        }
+        cursor += written;
+        totalBytes += OneByte * written;
+    }
+    trace.bytes(static_cast<size_t>(totalBytes));
+    return Utils::countOf<I>(totalBytes);
+}
+
+
 }
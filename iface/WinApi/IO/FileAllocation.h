@@ -0,0 +1,185 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <winioctl.h>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+// Reserves disk space up to `size` without zero filling it and without moving the end of file,
+// so later appends through fileWrite don't extend the allocation piece by piece.
+// Nothing is done when the file already has that much, since a smaller allocation
+// than the end of file truncates the file.
+template<typename F>
+requires IsFileAllowWrite<F>
+Maybe<void> preallocateFile(const F& file, const CountOfBytes size)
+{
+    FILE_STANDARD_INFO standard{};
+    if(FALSE == ::GetFileInformationByHandleEx(file.get(), FileStandardInfo, &standard, static_cast<DWORD>(sizeof(standard))))
+    {
+        return OccurredError{};
+    }
+    const auto wanted = static_cast<LONGLONG>(static_cast<size_t>(size));
+    if(wanted <= standard.AllocationSize.QuadPart || wanted <= standard.EndOfFile.QuadPart)
+    {
+        return {};
+    }
+
+    FILE_ALLOCATION_INFO allocation{};
+    allocation.AllocationSize.QuadPart = wanted;
+    const BOOL succeed = ::SetFileInformationByHandle
+    (
+          file.get()
+        , FileAllocationInfo
+        , &allocation
+        , static_cast<DWORD>(sizeof(allocation))
+    );
+    if(FALSE == succeed)
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+template<typename F>
+requires IsFileAllowWrite<F>
+Maybe<void> setFileSize(const F& file, const CountOfBytes size)
+{
+    FILE_END_OF_FILE_INFO endOfFile{};
+    endOfFile.EndOfFile.QuadPart = static_cast<LONGLONG>(static_cast<size_t>(size));
+    const BOOL succeed = ::SetFileInformationByHandle
+    (
+          file.get()
+        , FileEndOfFileInfo
+        , &endOfFile
+        , static_cast<DWORD>(sizeof(endOfFile))
+    );
+    if(FALSE == succeed)
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+template<typename F>
+requires IsFileAllowWrite<F>
+Maybe<void> setFileSparse(const F& file, const bool sparse = true)
+{
+    FILE_SET_SPARSE_BUFFER buffer{};
+    buffer.SetSparse = sparse ? TRUE : FALSE;
+    DWORD returned = 0u;
+    const BOOL succeed = ::DeviceIoControl
+    (
+          file.get()
+        , FSCTL_SET_SPARSE
+        , &buffer
+        , static_cast<DWORD>(sizeof(buffer))
+        , nullptr
+        , 0u
+        , &returned
+        , nullptr
+    );
+    if(FALSE == succeed)
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+// Zeroes the range, on a sparse file the clusters fully inside it are released.
+template<typename F>
+requires IsFileAllowWrite<F>
+Maybe<void> punchFileHole(const F& file, const FileRange range)
+{
+    FILE_ZERO_DATA_INFORMATION zero{};
+    zero.FileOffset.QuadPart      = static_cast<LONGLONG>(static_cast<size_t>(range.begin));
+    zero.BeyondFinalZero.QuadPart = static_cast<LONGLONG>(static_cast<size_t>(range.end()));
+    DWORD returned = 0u;
+    const BOOL succeed = ::DeviceIoControl
+    (
+          file.get()
+        , FSCTL_SET_ZERO_DATA
+        , &zero
+        , static_cast<DWORD>(sizeof(zero))
+        , nullptr
+        , 0u
+        , &returned
+        , nullptr
+    );
+    if(FALSE == succeed)
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+// Ranges of `range` backed by allocated storage, the rest reads as zeroes.
+template<typename F>
+requires IsFileAllowRead<F>
+Maybe<std::vector<FileRange>> getFileAllocatedRanges(const F& file, const FileRange range)
+{
+    std::vector<FileRange> ranges;
+    FILE_ALLOCATED_RANGE_BUFFER query{};
+    query.FileOffset.QuadPart = static_cast<LONGLONG>(static_cast<size_t>(range.begin));
+    query.Length.QuadPart     = static_cast<LONGLONG>(static_cast<size_t>(range.size));
+
+    FILE_ALLOCATED_RANGE_BUFFER found[64]{};
+    for(;;)
+    {
+        DWORD returned = 0u;
+        const BOOL succeed = ::DeviceIoControl
+        (
+              file.get()
+            , FSCTL_QUERY_ALLOCATED_RANGES
+            , &query
+            , static_cast<DWORD>(sizeof(query))
+            , found
+            , static_cast<DWORD>(sizeof(found))
+            , &returned
+            , nullptr
+        );
+        const bool moreData = FALSE == succeed && ::GetLastError() == ERROR_MORE_DATA;
+        if(FALSE == succeed && !moreData)
+        {
+            return OccurredError{};
+        }
+
+        const size_t count = returned / sizeof(FILE_ALLOCATED_RANGE_BUFFER);
+        for(size_t index = 0u; index < count; ++index)
+        {
+            ranges.push_back(FileRange
+            {
+                  .begin = CountOfBytes{} + OneByte * found[index].FileOffset.QuadPart
+                , .size  = CountOfBytes{} + OneByte * found[index].Length.QuadPart
+            });
+        }
+        if(!moreData || 0u == count)
+        {
+            break;
+        }
+
+        const LONGLONG queryEnd = query.FileOffset.QuadPart + query.Length.QuadPart;
+        query.FileOffset.QuadPart = found[count - 1u].FileOffset.QuadPart + found[count - 1u].Length.QuadPart;
+        query.Length.QuadPart     = queryEnd - query.FileOffset.QuadPart;
+    }
+    return std::move(ranges);
+}
+
+template<typename F>
+requires IsFileAllowRead<F>
+Maybe<std::vector<FileRange>> getFileAllocatedRanges(const F& file)
+{
+    auto size = getFileSize(file);
+    if(!size.okay())
+    {
+        return Maybe<std::vector<FileRange>>{size.code()};
+    }
+    return getFileAllocatedRanges(file, FileRange{CountOfBytes{}, size.value()});
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,92 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Apc.h>
+#include <WinApi/IO/File.h>
+#include <span>
+
+
+namespace WinApi::IO
+{
+
+// Called on the issuing thread inside an alertable wait with the bytes transferred,
+// fewer than requested at the end of the file.
+using IoCompletion = std::function<void(Maybe<CountOfBytes> transferred)>;
+
+struct IoRequest
+{
+    OVERLAPPED overlapped{};    // the completion routine gets its address
+    IoCompletion onComplete;
+};
+
+static void CALLBACK completeIoRequest(const DWORD error, const DWORD transferred, OVERLAPPED* const overlapped)
+{
+    WINAPI_TRACE_SCOPE(trace, "completeIoRequest");
+    const std::unique_ptr<IoRequest> request{CONTAINING_RECORD(overlapped, IoRequest, overlapped)};
+    if(ERROR_SUCCESS != error && ERROR_HANDLE_EOF != error)
+    {
+        trace.failed();
+        ::SetLastError(error);
+        request->onComplete(OccurredError{});
+        return;
+    }
+    trace.bytes(transferred);
+    request->onComplete(CountOfBytes{} + OneByte * transferred);
+}
+
+// ReadFileEx at `offset` into `buffer`, which must stay valid until the completion has run.
+// The file must be opened with FileFlag::Overllaped. A single request transfers
+// at most MAXDWORD bytes. No completion runs when issuing fails.
+template<typename F>
+requires IsFileAllowRead<F>
+Maybe<void> fileReadAsync(  const F& file
+                          , const CountOfBytes offset
+                          , const std::span<std::byte> buffer
+                          , IoCompletion onComplete )
+{
+    WINAPI_TRACE_SCOPE(trace, "fileReadAsync");
+    auto request = std::make_unique<IoRequest>(IoRequest{filePosition(offset), std::move(onComplete)});
+    if(FALSE == ::ReadFileEx
+    (
+          file.get()
+        , buffer.data()
+        , static_cast<DWORD>(std::min<size_t>(buffer.size(), MAXDWORD))
+        , &request->overlapped
+        , &completeIoRequest
+    ))
+    {
+        trace.failed();
+        return OccurredError{};
+    }
+    request.release(); // completeIoRequest owns it and traces the bytes transferred
+    return {};
+}
+
+template<typename F>
+requires IsFileAllowWrite<F>
+Maybe<void> fileWriteAsync(  const F& file
+                           , const CountOfBytes offset
+                           , const std::span<const std::byte> buffer
+                           , IoCompletion onComplete )
+{
+    WINAPI_TRACE_SCOPE(trace, "fileWriteAsync");
+    auto request = std::make_unique<IoRequest>(IoRequest{filePosition(offset), std::move(onComplete)});
+    if(FALSE == ::WriteFileEx
+    (
+          file.get()
+        , buffer.data()
+        , static_cast<DWORD>(std::min<size_t>(buffer.size(), MAXDWORD))
+        , &request->overlapped
+        , &completeIoRequest
+    ))
+    {
+        trace.failed();
+        return OccurredError{};
+    }
+    request.release(); // completeIoRequest owns it and traces the bytes transferred
+    return {};
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,295 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <WinApi/IO/FileAllocation.h>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+using CopyProgress = std::function<void(CountOfBytes copied, CountOfBytes total)>;
+
+struct CopyOptions
+{
+    CountOfBytes    bufferSize  = CountOfBytes{} + OneByte * (1u << 20);
+    size_t          buffers     = 4u;
+    bool            preallocate = true;
+    bool            unbuffered  = false; // path copy only: COPY_FILE_NO_BUFFERING
+    CopyProgress    progress    = {};
+    std::stop_token stop        = {};
+};
+
+
+// Copies `range` of `source` to the same range of `destination`.
+// A reader thread fills up to `options.buffers` buffers ahead of the writer,
+// so reading the next chunk overlaps with writing the previous one.
+template<typename S, typename D>
+requires IsFileAllowRead<S> && IsFileAllowWrite<D>
+Maybe<CountOfBytes> fileCopy(  const S& source
+                             , const D& destination
+                             , const FileRange range
+                             , const CopyOptions& options = {} )
+{
+    WINAPI_TRACE_SCOPE(trace, "fileCopy");
+    const size_t bufferSize = static_cast<size_t>(options.bufferSize);
+    const size_t buffers = std::max<size_t>(options.buffers, 2u);
+    if(0u == bufferSize)
+    {
+        ::SetLastError(ERROR_INVALID_PARAMETER);
+        return OccurredError{};
+    }
+
+    if(options.preallocate)
+    {
+        // best effort, the copy still works without it
+        const auto size = getFileSize(destination);
+        if(size.okay() && size.value() < range.end())
+        {
+            preallocateFile(destination, range.end());
+        }
+    }
+
+    // Page aligned, so the buffers also suit FileFlag::NoBuffering handles.
+    auto memory = safeHandle
+    (
+          ::VirtualAlloc(nullptr, bufferSize * buffers, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE)
+        , [](const HANDLE memory)
+        {
+            if(memory)
+            {
+                ::VirtualFree(memory, 0, MEM_RELEASE);
+            }
+        }
+    );
+    if(!memory)
+    {
+        return OccurredError{};
+    }
+
+    struct Chunk
+    {
+        std::byte*   data;
+        CountOfBytes offset;
+        CountOfBytes size;
+    };
+
+    std::mutex guard;
+    std::condition_variable changed;
+    std::deque<std::byte*> empty;
+    std::deque<Chunk> filled;
+    std::optional<OccurredError> readError;
+    bool readDone = false;
+    bool cancelled = false;
+
+    for(size_t index = 0u; index < buffers; ++index)
+    {
+        empty.push_back(static_cast<std::byte*>(memory.get()) + index * bufferSize);
+    }
+
+    std::jthread reader{[&]
+    {
+        for(CountOfBytes offset = range.begin; offset < range.end();)
+        {
+            std::byte* buffer = nullptr;
+            {
+                std::unique_lock lock{guard};
+                changed.wait(lock, [&]{ return cancelled || !empty.empty(); });
+                if(cancelled)
+                {
+                    break;
+                }
+                buffer = empty.front();
+                empty.pop_front();
+            }
+
+            const size_t wanted = std::min(bufferSize, static_cast<size_t>(range.end()) - static_cast<size_t>(offset));
+            auto read = fileReadAt(source, offset, buffer, buffer + wanted);
+
+            std::lock_guard lock{guard};
+            if(!read.okay())
+            {
+                readError = read.code();
+                break;
+            }
+            const CountOfBytes size = read.value();
+            if(CountOfBytes{} == size)
+            {
+                empty.push_back(buffer);
+                break; // end of file
+            }
+            filled.push_back(Chunk{buffer, offset, size});
+            changed.notify_all();
+            offset += size - CountOfBytes{};
+        }
+        std::lock_guard lock{guard};
+        readDone = true;
+        changed.notify_all();
+    }};
+
+    CountOfBytes copied{};
+    std::optional<OccurredError> writeError;
+    std::exception_ptr progressFailure;
+    for(;;)
+    {
+        Chunk chunk{};
+        {
+            std::unique_lock lock{guard};
+            changed.wait(lock, [&]{ return readDone || !filled.empty(); });
+            if(filled.empty())
+            {
+                break; // all written, a stop requested now is too late
+            }
+            if(options.stop.stop_requested())
+            {
+                cancelled = true;
+                changed.notify_all();
+                break;
+            }
+            chunk = filled.front();
+            filled.pop_front();
+        }
+
+        const std::byte* const data = chunk.data;
+        auto written = fileWriteAt(destination, chunk.offset, data, data + static_cast<size_t>(chunk.size));
+        if(!written.okay())
+        {
+            writeError = written.code();
+        }
+        else
+        {
+            copied += written.value() - CountOfBytes{};
+            if(options.progress)
+            {
+                try
+                {
+                    options.progress(copied, range.size);
+                }
+                catch(...)
+                {
+                    progressFailure = std::current_exception(); // rethrown once the reader has stopped
+                }
+            }
+        }
+
+        std::lock_guard lock{guard};
+        empty.push_back(chunk.data);
+        if(writeError || progressFailure)
+        {
+            cancelled = true;
+        }
+        changed.notify_all();
+        if(cancelled)
+        {
+            break;
+        }
+    }
+    reader.join();
+
+    if(progressFailure)
+    {
+        trace.failed();
+        std::rethrow_exception(progressFailure);
+    }
+
+    if(writeError)
+    {
+        trace.failed();
+        return Maybe<CountOfBytes>{*writeError};
+    }
+    if(readError)
+    {
+        trace.failed();
+        return Maybe<CountOfBytes>{*readError};
+    }
+    if(cancelled)
+    {
+        trace.failed();
+        ::SetLastError(ERROR_OPERATION_ABORTED);
+        return OccurredError{};
+    }
+    trace.bytes(static_cast<size_t>(copied));
+    return copied;
+}
+
+template<typename S, typename D>
+requires IsFileAllowRead<S> && IsFileAllowWrite<D>
+Maybe<CountOfBytes> fileCopy(  const S& source
+                             , const D& destination
+                             , const CopyOptions& options = {} )
+{
+    auto size = getFileSize(source);
+    if(!size.okay())
+    {
+        return Maybe<CountOfBytes>{size.code()};
+    }
+    return fileCopy(source, destination, FileRange{CountOfBytes{}, size.value()}, options);
+}
+
+
+// Whole file copy by path through CopyFileEx, which lets the system
+// offload the transfer (server side and ODX copies) when the volumes support it.
+static Maybe<void> copyFile(  const std::filesystem::path& source
+                            , const std::filesystem::path& destination
+                            , const CopyOptions& options = {} )
+{
+    struct Progress
+    {
+        const CopyOptions& options;
+        std::exception_ptr failure;     // must not unwind through CopyFileEx, rethrown after it
+    } progress{options};
+
+    auto routine = [](  const LARGE_INTEGER totalSize
+                      , const LARGE_INTEGER transferred
+                      , LARGE_INTEGER, LARGE_INTEGER, DWORD, DWORD, HANDLE, HANDLE
+                      , const LPVOID data ) -> DWORD
+    {
+        Progress& copy = *static_cast<Progress*>(data);
+        if(copy.options.progress)
+        {
+            try
+            {
+                copy.options.progress(  CountOfBytes{} + OneByte * transferred.QuadPart
+                                      , CountOfBytes{} + OneByte * totalSize.QuadPart  );
+            }
+            catch(...)
+            {
+                copy.failure = std::current_exception();
+                return PROGRESS_CANCEL;
+            }
+        }
+        return copy.options.stop.stop_requested() ? PROGRESS_CANCEL : PROGRESS_CONTINUE;
+    };
+
+    const BOOL succeed = ::CopyFileExW
+    (
+          source.c_str()
+        , destination.c_str()
+        , routine
+        , &progress
+        , nullptr
+        , options.unbuffered ? COPY_FILE_NO_BUFFERING : 0u
+    );
+    if(progress.failure)
+    {
+        std::rethrow_exception(progress.failure);
+    }
+    if(FALSE == succeed)
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,219 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+
+namespace WinApi::IO
+{
+
+struct FileHandleCacheOptions
+{
+    size_t capacity = 1024u;   // idle handles kept open
+    size_t maxOpen  = 0u;      // hard cap on open handles including those in use and invalidated, 0 for none
+    ShareMask shareMode = ShareFlag::Read | ShareFlag::Write | ShareFlag::Delete;
+    FileMask flags = FileFlag::Normal;
+};
+
+struct FileHandleCacheStats
+{
+    std::atomic<uint64_t> hits{0u};
+    std::atomic<uint64_t> misses{0u};
+    std::atomic<uint64_t> evictions{0u};
+
+    double hitRate() const noexcept
+    {
+        const uint64_t found = hits.load(std::memory_order_relaxed);
+        const uint64_t total = found + misses.load(std::memory_order_relaxed);
+        return total ? static_cast<double>(found) / static_cast<double>(total) : 0.0;
+    }
+};
+
+// Keeps recently used files open, keyed by path and access. Handles are shared: a handle
+// stays open while anyone holds it, eviction only drops the least recently used handles
+// which nobody holds. Files are opened with CreateMode::OpenExisting.
+// Threads share a handle and its file pointer, so they read and write it with fileReadAt
+// and fileWriteAt, setFilePointer followed by fileRead races with the other holders.
+// With FileFlag::Overllaped in the flags read with fileReadAtOverlapped instead.
+class FileHandleCache
+{
+public:
+    explicit FileHandleCache(const FileHandleCacheOptions& cacheOptions = {})
+        : options{cacheOptions}
+    {}
+
+    FileHandleCache(const FileHandleCache&) = delete;
+    FileHandleCache& operator = (const FileHandleCache&) = delete;
+
+    template<DesiredAccess desiredAccess>
+    using Shared = std::shared_ptr<const File<desiredAccess>>;
+
+    // ERROR_TOO_MANY_OPEN_FILES when maxOpen handles are in use.
+    template<DesiredAccess desiredAccess>
+    Maybe<Shared<desiredAccess>> open(const std::filesystem::path& path)
+    {
+        const Key key{path.native(), desiredAccess};
+        uint64_t started = 0u;
+        {
+            std::lock_guard lock{mutex};
+            if(auto found = lookup<desiredAccess>(key))
+            {
+                cacheStats.hits.fetch_add(1u, std::memory_order_relaxed);
+                return std::move(found);
+            }
+            while(options.maxOpen && openCount->load(std::memory_order_relaxed) >= options.maxOpen)
+            {
+                if(!evictOne())
+                {
+                    ::SetLastError(ERROR_TOO_MANY_OPEN_FILES);
+                    return OccurredError{};
+                }
+            }
+            openCount->fetch_add(1u, std::memory_order_relaxed); // reserved while the file opens
+            started = generation;
+        }
+        cacheStats.misses.fetch_add(1u, std::memory_order_relaxed);
+
+        auto file = createFile<desiredAccess>(path, options.shareMode, CreateMode::OpenExisting, options.flags);
+        if(!file.okay())
+        {
+            openCount->fetch_sub(1u, std::memory_order_relaxed);
+            return Maybe<Shared<desiredAccess>>{file.code()};
+        }
+        // counted until the last holder lets go, even once it has left the cache
+        Shared<desiredAccess> opened
+        {
+              new File<desiredAccess>{std::move(file).value()}
+            , [count = openCount](const File<desiredAccess>* const closed)
+            {
+                delete closed;
+                count->fetch_sub(1u, std::memory_order_relaxed);
+            }
+        };
+
+        std::lock_guard lock{mutex};
+        if(started != generation)
+        {
+            // an invalidation meanwhile may be for a file replaced after ours was opened
+            return Shared<desiredAccess>{std::move(opened)};
+        }
+        if(auto raced = lookup<desiredAccess>(key))
+        {
+            return std::move(raced); // another thread opened it meanwhile, ours is closed
+        }
+        order.push_front(key);
+        entries.emplace(key, Entry{opened, order.begin()});
+        trim();
+        return Shared<desiredAccess>{std::move(opened)};
+    }
+
+    // Drops the cached handles of `path`, e.g. before the file is deleted or replaced.
+    // Handles still held stay open and count towards maxOpen until they are released.
+    void invalidate(const std::filesystem::path& path)
+    {
+        std::lock_guard lock{mutex};
+        ++generation;
+        for(auto entry = entries.begin(); entry != entries.end();)
+        {
+            if(entry->first.path == path.native())
+            {
+                order.erase(entry->second.position);
+                entry = entries.erase(entry);
+            }
+            else
+            {
+                ++entry;
+            }
+        }
+    }
+
+    // Handles the cache opened which are still open, cached or not.
+    size_t openHandles() const noexcept
+    {
+        return openCount->load(std::memory_order_relaxed);
+    }
+
+    const FileHandleCacheStats& stats() const noexcept
+    {
+        return cacheStats;
+    }
+
+private:
+    struct Key
+    {
+        std::filesystem::path::string_type path;
+        DesiredAccess access;
+
+        bool operator == (const Key&) const = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator () (const Key& key) const noexcept
+        {
+            return std::hash<std::filesystem::path::string_type>{}(key.path) ^ static_cast<size_t>(key.access);
+        }
+    };
+
+    struct Entry
+    {
+        std::shared_ptr<const void> file;
+        std::list<Key>::iterator position;
+    };
+
+    template<DesiredAccess desiredAccess>
+    Shared<desiredAccess> lookup(const Key& key)
+    {
+        const auto found = entries.find(key);
+        if(found == entries.end())
+        {
+            return {};
+        }
+        order.splice(order.begin(), order, found->second.position);
+        return std::static_pointer_cast<const File<desiredAccess>>(found->second.file);
+    }
+
+    // Drops the least recently used handle which only the cache holds.
+    bool evictOne()
+    {
+        for(auto key = order.rbegin(); key != order.rend(); ++key)
+        {
+            const auto entry = entries.find(*key);
+            if(1 == entry->second.file.use_count())
+            {
+                order.erase(std::next(key).base());
+                entries.erase(entry);
+                cacheStats.evictions.fetch_add(1u, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Handles in use may keep the cache above capacity until they are released.
+    void trim()
+    {
+        while(entries.size() > options.capacity && evictOne())
+        {}
+    }
+
+    const FileHandleCacheOptions options;
+    FileHandleCacheStats cacheStats;
+    const std::shared_ptr<std::atomic<size_t>> openCount = std::make_shared<std::atomic<size_t>>(0u);
+
+    std::mutex mutex;
+    uint64_t generation = 0u;   // of invalidations, an open which saw one since its miss doesn't cache
+    std::list<Key> order;   // most recently used first
+    std::unordered_map<Key, Entry, KeyHash> entries;
+
+}; // class FileHandleCache
+
+} // namespace WinApi::IO
@@ -0,0 +1,94 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <WinApi/IO/FileMapping.h>
+#include <span>
+
+
+namespace WinApi::IO
+{
+
+// Asks the memory manager to bring the pages of a mapped range in with large,
+// batched reads before they are touched.
+static Maybe<void> prefetchMemory(const std::span<const std::byte> memory)
+{
+    WIN32_MEMORY_RANGE_ENTRY entry{};
+    entry.VirtualAddress = const_cast<std::byte*>(memory.data());
+    entry.NumberOfBytes  = memory.size();
+    if(FALSE == ::PrefetchVirtualMemory(::GetCurrentProcess(), 1u, &entry, 0u))
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+// Drops the pages of a mapped range from the working set after they were processed.
+// Clean pages go to the standby list, so this is a hint, not a discard of the data.
+static Maybe<void> evictMemory(const std::span<const std::byte> memory)
+{
+    // VirtualUnlock of pages which are not locked removes them from the working set.
+    const BOOL succeed = ::VirtualUnlock(const_cast<std::byte*>(memory.data()), memory.size());
+    if(FALSE == succeed && ::GetLastError() != ERROR_NOT_LOCKED)
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+// Reads `range` of the file into the system cache ahead of time without
+// copying it anywhere, through a temporary read only view.
+template<typename F>
+requires IsFileAllowRead<F>
+Maybe<void> prefetchFile(const F& file, const FileRange range)
+{
+    WINAPI_TRACE_SCOPE(trace, "prefetchFile");
+    auto mapping = createFileMapping(file, PageProtection::ReadOnly);
+    if(!mapping.okay())
+    {
+        trace.failed();
+        return Maybe<void>{mapping.code()};
+    }
+    auto view = mapViewOfFile(mapping.value(), ViewAccess::Read, range);
+    if(!view.okay())
+    {
+        trace.failed();
+        return Maybe<void>{view.code()};
+    }
+    trace.bytes(static_cast<size_t>(range.size));
+    return prefetchMemory(view.value().data);
+}
+
+
+enum class AccessHint: DWORD
+{
+      Normal     = 0u
+    , Sequential = FILE_FLAG_SEQUENTIAL_SCAN
+    , Random     = FILE_FLAG_RANDOM_ACCESS
+};
+
+// Opens a second handle to the same file with another read ahead policy, so a scan can
+// switch between sequential and random regions without closing the file.
+template<typename F>
+requires IsFileAllowRead<F>
+Maybe<F> reopenFile(  const F& file
+                    , const AccessHint hint
+                    , const ShareMask shareMode = ShareFlag::Read | ShareFlag::Write )
+{
+    const HANDLE handle = ::ReOpenFile
+    (
+          file.get()
+        , static_cast<DWORD>(fileAccess<F>())
+        , static_cast<DWORD>(shareMode)
+        , static_cast<DWORD>(hint)
+    );
+    if(handle == INVALID_HANDLE_VALUE)
+    {
+        return OccurredError{};
+    }
+    return F{handle, typename F::deleter_type{}};
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,239 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+// Identifies a file on the machine regardless of the path it is opened by, e.g. hard links.
+struct FileId
+{
+    ULONGLONG volume = 0u;
+    std::array<BYTE, 16> file{};
+
+    bool operator == (const FileId&) const = default;
+};
+
+struct FileInfo
+{
+    CountOfBytes size;
+    CountOfBytes allocated;                     // on disk, sparse and compressed files take less
+    std::filesystem::file_time_type created;
+    std::filesystem::file_time_type lastAccess;
+    std::filesystem::file_time_type lastWrite;
+    std::filesystem::file_time_type changed;    // data or metadata
+    DWORD attributes = 0u;                      // FILE_ATTRIBUTE_*
+    DWORD links = 0u;
+    FileId id;
+
+    bool isDirectory() const noexcept
+    {
+        return 0u != (attributes & FILE_ATTRIBUTE_DIRECTORY);
+    }
+};
+
+static std::filesystem::file_time_type fileTimeOf(const LARGE_INTEGER& time) noexcept
+{
+    // FILETIME ticks, the representation of file_time_type on Windows
+    return std::filesystem::file_time_type{std::filesystem::file_time_type::duration{time.QuadPart}};
+}
+
+static Maybe<FileInfo> fileInfoOf(const HANDLE file)
+{
+    FILE_BASIC_INFO basic{};
+    FILE_STANDARD_INFO standard{};
+    if(FALSE == ::GetFileInformationByHandleEx(file, FileBasicInfo, &basic, sizeof(basic))
+       || FALSE == ::GetFileInformationByHandleEx(file, FileStandardInfo, &standard, sizeof(standard)))
+    {
+        return OccurredError{};
+    }
+
+    FileInfo info;
+    info.size       = CountOfBytes{} + OneByte * standard.EndOfFile.QuadPart;
+    info.allocated  = CountOfBytes{} + OneByte * standard.AllocationSize.QuadPart;
+    info.created    = fileTimeOf(basic.CreationTime);
+    info.lastAccess = fileTimeOf(basic.LastAccessTime);
+    info.lastWrite  = fileTimeOf(basic.LastWriteTime);
+    info.changed    = fileTimeOf(basic.ChangeTime);
+    info.attributes = basic.FileAttributes;
+    info.links      = standard.NumberOfLinks;
+
+    FILE_ID_INFO id{};
+    if(FALSE != ::GetFileInformationByHandleEx(file, FileIdInfo, &id, sizeof(id)))
+    {
+        info.id.volume = id.VolumeSerialNumber;
+        std::memcpy(info.id.file.data(), id.FileId.Identifier, info.id.file.size());
+    }
+    else
+    {
+        // FileIdInfo needs Windows 8 and a file system which supports it
+        BY_HANDLE_FILE_INFORMATION legacy{};
+        if(FALSE == ::GetFileInformationByHandle(file, &legacy))
+        {
+            return OccurredError{};
+        }
+        const ULONGLONG index = (static_cast<ULONGLONG>(legacy.nFileIndexHigh) << 32) | legacy.nFileIndexLow;
+        info.id.volume = legacy.dwVolumeSerialNumber;
+        std::memcpy(info.id.file.data(), &index, sizeof(index));
+    }
+    return std::move(info);
+}
+
+template<typename F>
+requires IsItFile<F>
+Maybe<FileInfo> getFileInfo(const F& file)
+{
+    return fileInfoOf(file.get());
+}
+
+// Opens the path for attributes only, so it works for directories and files opened
+// by others without sharing.
+static Maybe<FileInfo> getPathInfo(const std::filesystem::path& path)
+{
+    WINAPI_TRACE_SCOPE(trace, "getPathInfo");
+    const HANDLE handle = ::CreateFileW
+    (
+          path.c_str()
+        , FILE_READ_ATTRIBUTES
+        , FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE
+        , NULL
+        , OPEN_EXISTING
+        , FILE_FLAG_BACKUP_SEMANTICS
+        , NULL
+    );
+    if(handle == INVALID_HANDLE_VALUE)
+    {
+        trace.failed();
+        return OccurredError{};
+    }
+    const auto file = safeHandle(handle, [](const HANDLE handle)
+    {
+        ::CloseHandle(handle);
+    });
+    return fileInfoOf(file.get());
+}
+
+// One result per path, in order, a failure of one path does not affect the others.
+static std::vector<Maybe<FileInfo>> getPathsInfo(const std::span<const std::filesystem::path> paths)
+{
+    std::vector<Maybe<FileInfo>> infos;
+    infos.reserve(paths.size());
+    for(const std::filesystem::path& path : paths)
+    {
+        infos.push_back(getPathInfo(path));
+    }
+    return infos;
+}
+
+
+struct FileInfoCacheStats
+{
+    std::atomic<uint64_t> hits{0u};
+    std::atomic<uint64_t> misses{0u};
+    std::atomic<uint64_t> invalidations{0u};
+};
+
+// Remembers getPathInfo results by path until they are invalidated, e.g. when
+// a change notification for the path arrives. Failures are not cached.
+// Spellings of one path share an entry, see key.
+class FileInfoCache
+{
+public:
+    FileInfoCache() = default;
+    FileInfoCache(const FileInfoCache&) = delete;
+    FileInfoCache& operator = (const FileInfoCache&) = delete;
+
+    Maybe<FileInfo> get(const std::filesystem::path& path)
+    {
+        const Key pathKey = key(path);
+        uint64_t started = 0u;
+        {
+            std::lock_guard lock{mutex};
+            const auto found = infos.find(pathKey);
+            if(found != infos.end())
+            {
+                cacheStats.hits.fetch_add(1u, std::memory_order_relaxed);
+                return FileInfo{found->second};
+            }
+            started = generation;
+        }
+        cacheStats.misses.fetch_add(1u, std::memory_order_relaxed);
+        auto info = getPathInfo(path);
+        if(info.okay())
+        {
+            std::lock_guard lock{mutex};
+            if(started == generation)
+            {
+                // an invalidation meanwhile may be for a change the info predates
+                infos.insert_or_assign(pathKey, info.value());
+            }
+        }
+        return std::move(info);
+    }
+
+    void invalidate(const std::filesystem::path& path)
+    {
+        const Key pathKey = key(path);
+        std::lock_guard lock{mutex};
+        ++generation;
+        cacheStats.invalidations.fetch_add(infos.erase(pathKey), std::memory_order_relaxed);
+    }
+
+    // When notifications were lost and any entry may be stale.
+    void invalidateAll()
+    {
+        std::lock_guard lock{mutex};
+        ++generation;
+        cacheStats.invalidations.fetch_add(infos.size(), std::memory_order_relaxed);
+        infos.clear();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard lock{mutex};
+        return infos.size();
+    }
+
+    const FileInfoCacheStats& stats() const noexcept
+    {
+        return cacheStats;
+    }
+
+private:
+    using Key = std::filesystem::path::string_type;
+
+    // Absolute, normalized, with backslashes and in upper case, since names compare
+    // without case, so `C:\d\f`, `C:/d/f`, `d\f` and `C:\D\F` are one key.
+    static Key key(const std::filesystem::path& path)
+    {
+        std::error_code error;
+        std::filesystem::path absolute = std::filesystem::absolute(path, error);
+        if(error)
+        {
+            absolute = path;
+        }
+        Key normal = absolute.lexically_normal().make_preferred().native();
+        ::CharUpperBuffW(normal.data(), static_cast<DWORD>(normal.size()));
+        return normal;
+    }
+
+    FileInfoCacheStats cacheStats;
+
+    mutable std::mutex mutex;
+    uint64_t generation = 0u;   // of invalidations, a get which saw one since its miss doesn't cache
+    std::unordered_map<Key, FileInfo> infos;
+
+}; // class FileInfoCache
+
+} // namespace WinApi::IO
@@ -0,0 +1,296 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+enum class LockMode: DWORD
+{
+      Shared    = 0u
+    , Exclusive = LOCKFILE_EXCLUSIVE_LOCK
+};
+
+template<typename F>
+requires IsItFile<F>
+Maybe<void> unlockFileRange(const F& file, const FileRange range)
+{
+    OVERLAPPED position = filePosition(range.begin);
+    const ULARGE_INTEGER size{.QuadPart = static_cast<size_t>(range.size)};
+    if(FALSE == ::UnlockFileEx(file.get(), 0u, size.LowPart, size.HighPart, &position))
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+// Releases its range of the file when destroyed. Must not outlive the file handle.
+template<typename F>
+struct FileLockGuard
+{
+    FileLockGuard() noexcept = default;
+
+    FileLockGuard(const F& lockedFile, const FileRange lockedRange) noexcept
+        : file{&lockedFile}
+        , range{lockedRange}
+    {}
+
+    FileLockGuard(FileLockGuard&& other) noexcept
+        : file{std::exchange(other.file, nullptr)}
+        , range{other.range}
+    {}
+
+    FileLockGuard& operator = (FileLockGuard&& other) noexcept
+    {
+        if(this != &other)
+        {
+            unlock();
+            file = std::exchange(other.file, nullptr);
+            range = other.range;
+        }
+        return *this;
+    }
+
+    ~FileLockGuard()
+    {
+        unlock();
+    }
+
+    explicit operator bool () const noexcept
+    {
+        return nullptr != file;
+    }
+
+    Maybe<void> unlock() noexcept
+    {
+        if(const F* const locked = std::exchange(file, nullptr))
+        {
+            return unlockFileRange(*locked, range);
+        }
+        return {};
+    }
+
+private:
+    const F* file = nullptr;
+    FileRange range{};
+
+}; // struct FileLockGuard
+
+// Fails at once with ERROR_LOCK_VIOLATION when another handle holds a conflicting lock.
+template<typename F>
+requires IsItFile<F>
+Maybe<FileLockGuard<F>> tryLockFileRange(const F& file, const FileRange range, const LockMode mode)
+{
+    OVERLAPPED position = filePosition(range.begin);
+    const ULARGE_INTEGER size{.QuadPart = static_cast<size_t>(range.size)};
+    const BOOL locked = ::LockFileEx
+    (
+          file.get()
+        , static_cast<DWORD>(mode) | LOCKFILE_FAIL_IMMEDIATELY
+        , 0u
+        , size.LowPart
+        , size.HighPart
+        , &position
+    );
+    if(FALSE == locked)
+    {
+        return OccurredError{};
+    }
+    return FileLockGuard<F>{file, range};
+}
+
+// Locks `range` of the file for this handle. Locks are mandatory: reads and writes
+// of other handles into an exclusively locked range fail until it is unlocked.
+// A finite timeout polls with growing pauses and ends with ERROR_TIMEOUT.
+template<typename F>
+requires IsItFile<F>
+Maybe<FileLockGuard<F>> lockFileRange(  const F& file
+                                      , const FileRange range
+                                      , const LockMode mode
+                                      , const Milliseconds timeout = Infinite )
+{
+    WINAPI_TRACE_SCOPE(trace, "lockFileRange");
+    if(Infinite == timeout)
+    {
+        OVERLAPPED position = filePosition(range.begin);
+        const ULARGE_INTEGER size{.QuadPart = static_cast<size_t>(range.size)};
+        const BOOL locked = ::LockFileEx
+        (
+              file.get()
+            , static_cast<DWORD>(mode)
+            , 0u
+            , size.LowPart
+            , size.HighPart
+            , &position
+        );
+        if(FALSE == locked)
+        {
+            trace.failed();
+            return OccurredError{};
+        }
+        return FileLockGuard<F>{file, range};
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto pause = std::chrono::microseconds{50};
+    for(;;)
+    {
+        auto locked = tryLockFileRange(file, range, mode);
+        if(locked.okay() || ERROR_LOCK_VIOLATION != static_cast<DWORD>(locked.code().code().value()))
+        {
+            return locked;
+        }
+        if(std::chrono::steady_clock::now() >= deadline)
+        {
+            trace.failed();
+            ::SetLastError(ERROR_TIMEOUT);
+            return OccurredError{};
+        }
+        std::this_thread::sleep_for(pause);
+        pause = std::min<std::chrono::microseconds>(pause * 2, std::chrono::milliseconds{10});
+    }
+}
+
+
+// Byte range locks between the threads of one process. File locks belong to handles,
+// so threads sharing a handle need this table to keep off each other's ranges.
+// Threads working on disjoint ranges never wait for each other.
+class RangeLockTable
+{
+public:
+    struct Guard
+    {
+        Guard() noexcept = default;
+
+        Guard(RangeLockTable& lockTable, const uint64_t lockId) noexcept
+            : table{&lockTable}
+            , id{lockId}
+        {}
+
+        Guard(Guard&& other) noexcept
+            : table{std::exchange(other.table, nullptr)}
+            , id{other.id}
+        {}
+
+        Guard& operator = (Guard&& other) noexcept
+        {
+            if(this != &other)
+            {
+                unlock();
+                table = std::exchange(other.table, nullptr);
+                id = other.id;
+            }
+            return *this;
+        }
+
+        ~Guard()
+        {
+            unlock();
+        }
+
+        explicit operator bool () const noexcept
+        {
+            return nullptr != table;
+        }
+
+        void unlock() noexcept
+        {
+            if(RangeLockTable* const locked = std::exchange(table, nullptr))
+            {
+                locked->release(id);
+            }
+        }
+
+    private:
+        RangeLockTable* table = nullptr;
+        uint64_t id = 0u;
+
+    }; // struct Guard
+
+    RangeLockTable() = default;
+    RangeLockTable(const RangeLockTable&) = delete;
+    RangeLockTable& operator = (const RangeLockTable&) = delete;
+
+    // An empty guard when the range is not free.
+    Guard tryLock(const FileRange range, const LockMode mode)
+    {
+        std::lock_guard lock{mutex};
+        if(conflicts(range, mode))
+        {
+            return {};
+        }
+        return Guard{*this, acquire(range, mode)};
+    }
+
+    Maybe<Guard> lock(const FileRange range, const LockMode mode, const Milliseconds timeout = Infinite)
+    {
+        std::unique_lock lock{mutex};
+        auto free = [&]{ return !conflicts(range, mode); };
+        if(Infinite == timeout)
+        {
+            released.wait(lock, free);
+        }
+        else if(!released.wait_for(lock, timeout, free))
+        {
+            ::SetLastError(ERROR_TIMEOUT);
+            return OccurredError{};
+        }
+        return Guard{*this, acquire(range, mode)};
+    }
+
+private:
+    struct Held
+    {
+        FileRange range;
+        LockMode mode;
+        uint64_t id;
+    };
+
+    bool conflicts(const FileRange range, const LockMode mode) const noexcept
+    {
+        return std::any_of(held.begin(), held.end(), [&](const Held& other)
+        {
+            const bool overlap = other.range.begin < range.end() && range.begin < other.range.end();
+            return overlap && (LockMode::Exclusive == mode || LockMode::Exclusive == other.mode);
+        });
+    }
+
+    uint64_t acquire(const FileRange range, const LockMode mode)
+    {
+        held.push_back(Held{range, mode, ++lastId});
+        return lastId;
+    }
+
+    void release(const uint64_t id) noexcept
+    {
+        {
+            std::lock_guard lock{mutex};
+            const auto found = std::find_if(held.begin(), held.end(), [&](const Held& entry){ return entry.id == id; });
+            if(found != held.end())
+            {
+                *found = held.back();
+                held.pop_back();
+            }
+        }
+        released.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable released;
+    std::vector<Held> held;
+    uint64_t lastId = 0u;
+
+}; // class RangeLockTable
+
+} // namespace WinApi::IO
@@ -0,0 +1,124 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <memoryapi.h>
+#include <span>
+
+
+namespace WinApi::IO
+{
+
+enum class PageProtection: DWORD
+{
+      ReadOnly  = PAGE_READONLY
+    , ReadWrite = PAGE_READWRITE
+    , WriteCopy = PAGE_WRITECOPY
+};
+
+enum class ViewAccess: DWORD
+{
+      Read      = FILE_MAP_READ
+    , Write     = FILE_MAP_WRITE
+    , ReadWrite = FILE_MAP_READ | FILE_MAP_WRITE
+    , Copy      = FILE_MAP_COPY
+};
+
+static CountOfBytes allocationGranularity() noexcept
+{
+    SYSTEM_INFO info{};
+    ::GetSystemInfo(&info);
+    return CountOfBytes{} + OneByte * info.dwAllocationGranularity;
+}
+
+
+static auto fileMappingOf(const HANDLE handle)
+{
+    auto mapping = safeHandle(handle, [](const HANDLE handle)
+    {
+        if(handle)
+        {
+            ::CloseHandle(handle);
+        }
+    });
+    using Result = decltype(mapping);
+
+    if(!mapping)
+    {
+        return Maybe<Result>{OccurredError{}};
+    }
+    return Maybe<Result>{std::move(mapping)};
+}
+
+using MaybeFileMapping = decltype(fileMappingOf(HANDLE{}));
+using FileMapping = typename MaybeFileMapping::Type;
+
+// `maxSize` of zero maps the whole current file.
+template<typename F>
+requires IsFileAllowRead<F>
+MaybeFileMapping createFileMapping(  const F& file
+                                   , const PageProtection protection
+                                   , const CountOfBytes maxSize = {}
+                                   , const StringView& name = {} )
+{
+    const ULARGE_INTEGER size{.QuadPart = static_cast<size_t>(maxSize)};
+    return fileMappingOf(::CreateFileMapping
+    (
+          file.get()
+        , nullptr
+        , static_cast<DWORD>(protection)
+        , size.HighPart
+        , size.LowPart
+        , name.empty() ? nullptr : name.data()
+    ));
+}
+
+
+template<typename C>
+struct MappedView
+{
+    Handle<C> base;             // start of the mapping, aligned to the allocation granularity
+    std::span<std::byte> data;  // the requested range
+};
+
+// Maps `range` of the mapping. The view itself starts at the allocation granularity
+// boundary below `range.begin`, `data` points exactly at the requested bytes.
+static auto mapViewOfFile(const FileMapping& mapping, const ViewAccess access, const FileRange range)
+{
+    const size_t granularity = static_cast<size_t>(allocationGranularity());
+    const size_t begin = static_cast<size_t>(range.begin);
+    const size_t alignedBegin = begin - begin % granularity;
+    const size_t lead = begin - alignedBegin;
+    const ULARGE_INTEGER offset{.QuadPart = alignedBegin};
+
+    void* const address = ::MapViewOfFile
+    (
+          mapping.get()
+        , static_cast<DWORD>(access)
+        , offset.HighPart
+        , offset.LowPart
+        , lead + static_cast<size_t>(range.size)
+    );
+    auto base = safeHandle(address, [](const HANDLE address)
+    {
+        if(address)
+        {
+            ::UnmapViewOfFile(address);
+        }
+    });
+    using View = MappedView<typename decltype(base)::deleter_type>;
+
+    if(!base)
+    {
+        return Maybe<View>{OccurredError{}};
+    }
+    const auto data = std::span<std::byte>{static_cast<std::byte*>(address) + lead, static_cast<size_t>(range.size)};
+    return Maybe<View>{View{std::move(base), data}};
+}
+
+using MaybeFileView = decltype(mapViewOfFile(std::declval<const FileMapping&>(), ViewAccess::Read, FileRange{}));
+using FileView = typename MaybeFileView::Type;
+
+} // namespace WinApi::IO
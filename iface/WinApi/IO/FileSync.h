@@ -0,0 +1,242 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <WinApi/IO/FileMapping.h>
+#include <WinApi/Sync/Event.h>
+#include <memory>
+#include <span>
+
+
+namespace WinApi::IO
+{
+
+// Writes the cached data and metadata of the file to the device and flushes its cache.
+template<typename F>
+requires IsFileAllowWrite<F>
+Maybe<void> flushFile(const F& file)
+{
+    WINAPI_TRACE_SCOPE(trace, "flushFile");
+    if(FALSE == ::FlushFileBuffers(file.get()))
+    {
+        trace.failed();
+        return OccurredError{};
+    }
+    return {};
+}
+
+
+struct NtFlushFunctions
+{
+    struct IoStatusBlock
+    {
+        union
+        {
+            LONG  status;
+            PVOID pointer;
+        };
+        ULONG_PTR information;
+    };
+    using FlushBuffersFileEx = LONG  (WINAPI *)(HANDLE, ULONG, PVOID, ULONG, IoStatusBlock*);
+    using StatusToDosError   = ULONG (WINAPI *)(LONG);
+
+    static constexpr ULONG DataSyncOnly = 0x00000004u; // FLUSH_FLAGS_FILE_DATA_SYNC_ONLY
+
+    FlushBuffersFileEx flushBuffersFileEx = nullptr;
+    StatusToDosError   statusToDosError   = nullptr;
+};
+
+// NtFlushBuffersFileEx is not in the import libraries, it is looked up once.
+static const NtFlushFunctions& ntFlushFunctions() noexcept
+{
+    static const NtFlushFunctions functions = []
+    {
+        NtFlushFunctions found{};
+        if(const HMODULE ntdll = ::GetModuleHandleW(L"ntdll.dll"))
+        {
+            found.flushBuffersFileEx = reinterpret_cast<NtFlushFunctions::FlushBuffersFileEx>(
+                reinterpret_cast<void*>(::GetProcAddress(ntdll, "NtFlushBuffersFileEx")));
+            found.statusToDosError = reinterpret_cast<NtFlushFunctions::StatusToDosError>(
+                reinterpret_cast<void*>(::GetProcAddress(ntdll, "RtlNtStatusToDosError")));
+        }
+        if(!found.statusToDosError)
+        {
+            found.flushBuffersFileEx = nullptr;
+        }
+        return found;
+    }();
+    return functions;
+}
+
+// Like fdatasync: makes the file data durable but skips the metadata which is not
+// needed to read it back, e.g. the last write time. Falls back to flushFile on systems
+// or file systems without data only flushes.
+template<typename F>
+requires IsFileAllowWrite<F>
+Maybe<void> syncFileData(const F& file)
+{
+    WINAPI_TRACE_SCOPE(trace, "syncFileData");
+    const NtFlushFunctions& nt = ntFlushFunctions();
+    if(nt.flushBuffersFileEx)
+    {
+        NtFlushFunctions::IoStatusBlock status{};
+        const LONG result = nt.flushBuffersFileEx(file.get(), NtFlushFunctions::DataSyncOnly, nullptr, 0u, &status);
+        if(result >= 0)
+        {
+            return {};
+        }
+        const ULONG error = nt.statusToDosError(result);
+        if(ERROR_INVALID_PARAMETER != error && ERROR_NOT_SUPPORTED != error)
+        {
+            trace.failed();
+            ::SetLastError(error);
+            return OccurredError{};
+        }
+    }
+    return flushFile(file);
+}
+
+// Starts writing back the dirty pages of a mapped range and waits for it,
+// the range counterpart of syncFileData for files changed through views.
+static Maybe<void> flushMemory(const std::span<const std::byte> memory)
+{
+    if(FALSE == ::FlushViewOfFile(memory.data(), memory.size()))
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+// Writes back `range` of the file only, through a temporary view of the cached file.
+// As with sync_file_range the device cache is not flushed, syncFileData does that.
+template<typename F>
+requires IsFileAllowRead<F> && IsFileAllowWrite<F>
+Maybe<void> syncFileRange(const F& file, const FileRange range)
+{
+    WINAPI_TRACE_SCOPE(trace, "syncFileRange");
+    auto mapping = createFileMapping(file, PageProtection::ReadOnly);
+    if(!mapping.okay())
+    {
+        trace.failed();
+        return Maybe<void>{mapping.code()};
+    }
+    auto view = mapViewOfFile(mapping.value(), ViewAccess::Read, range);
+    if(!view.okay())
+    {
+        trace.failed();
+        return Maybe<void>{view.code()};
+    }
+    trace.bytes(static_cast<size_t>(range.size));
+    return flushMemory(view.value().data);
+}
+
+
+// Flush running on the thread pool, see flushFileAsync.
+class FlushTask
+{
+    struct State
+    {
+        HANDLE file = nullptr;              // duplicate closed by the flush
+        Sync::ManualEvent done;
+        DWORD error = ERROR_IO_PENDING;     // read once `done` is set
+    };
+
+public:
+    // Flushes `file` on the thread pool and closes it afterwards.
+    static Maybe<FlushTask> start(const HANDLE file)
+    {
+        auto done = Sync::createManualEvent();
+        if(!done.okay())
+        {
+            ::CloseHandle(file);
+            return Maybe<FlushTask>{done.code()};
+        }
+        auto state = std::make_shared<State>();
+        state->file = file;
+        state->done = std::move(done).value();
+
+        auto owner = std::make_unique<std::shared_ptr<State>>(state);
+        if(FALSE == ::TrySubmitThreadpoolCallback(&flush, owner.get(), nullptr))
+        {
+            const OccurredError error{};
+            ::CloseHandle(file);
+            return error;
+        }
+        owner.release(); // flush owns it now
+        return FlushTask{std::move(state)};
+    }
+
+    FlushTask() noexcept = default;
+
+    // Signaled when the flush has finished, so it can be passed to waitFor.
+    const Sync::ManualEvent& event() const noexcept
+    {
+        return state->done;
+    }
+
+    // ERROR_IO_PENDING while the flush is still running.
+    Maybe<void> result() const
+    {
+        if(WAIT_OBJECT_0 != ::WaitForSingleObjectEx(state->done.get(), 0u, FALSE))
+        {
+            ::SetLastError(ERROR_IO_PENDING);
+            return OccurredError{};
+        }
+        if(ERROR_SUCCESS != state->error)
+        {
+            ::SetLastError(state->error);
+            return OccurredError{};
+        }
+        return {};
+    }
+
+private:
+    explicit FlushTask(std::shared_ptr<State>&& shared) noexcept
+        : state{std::move(shared)}
+    {}
+
+    static void CALLBACK flush(PTP_CALLBACK_INSTANCE, const PVOID parameter)
+    {
+        const std::unique_ptr<std::shared_ptr<State>> owner{static_cast<std::shared_ptr<State>*>(parameter)};
+        State& flushed = **owner;
+        flushed.error = FALSE != ::FlushFileBuffers(flushed.file) ? ERROR_SUCCESS : ::GetLastError();
+        ::CloseHandle(flushed.file);
+        Sync::setEvent(flushed.done);
+    }
+
+    std::shared_ptr<State> state;
+
+}; // class FlushTask
+
+// Flushes the file on the thread pool. The flush works on its own duplicate of the handle,
+// `file` may be closed meanwhile.
+template<typename F>
+requires IsFileAllowWrite<F>
+Maybe<FlushTask> flushFileAsync(const F& file)
+{
+    HANDLE duplicate = nullptr;
+    const BOOL duplicated = ::DuplicateHandle
+    (
+          ::GetCurrentProcess()
+        , file.get()
+        , ::GetCurrentProcess()
+        , &duplicate
+        , 0u
+        , FALSE
+        , DUPLICATE_SAME_ACCESS
+    );
+    if(FALSE == duplicated)
+    {
+        return OccurredError{};
+    }
+    return FlushTask::start(duplicate);
+}
+
+static Maybe<void> flushResult(const FlushTask& task)
+{
+    return task.result();
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,212 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <WinApi/IO/FileSync.h>
+#include <WinApi/Trace.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+struct LogWriterOptions
+{
+    // How long the flusher keeps collecting records after the first one arrived.
+    std::chrono::microseconds batchWindow{200};
+    // A batch this large is flushed at once, without waiting for the window to end.
+    CountOfBytes batchSize = CountOfBytes{} + OneByte * (1u << 20);
+    // Finishes every batch with syncFileData. Not needed for FileFlag::WriteThrough files.
+    bool syncData = true;
+};
+
+struct LogWriterStats
+{
+    std::atomic<uint64_t> flushes{0u};
+    std::atomic<uint64_t> records{0u};
+    std::atomic<uint64_t> bytes{0u};
+    std::atomic<uint64_t> largestFlush{0u};   // records
+    Trace::Histogram commitLatency;           // from append to durable, per record
+
+    double recordsPerFlush() const noexcept
+    {
+        const uint64_t count = flushes.load(std::memory_order_relaxed);
+        return count ? static_cast<double>(records.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+    }
+};
+
+// Append only log with group commit. Any number of threads append records, a single
+// flusher thread writes everything collected during the batch window in one fileWrite
+// followed by one syncFileData, so a single device flush makes the whole batch durable.
+// A write which fails may leave part of its batch in the file, so the writer stops there,
+// later appends fail with the same error, and the log has to be recovered and reopened.
+template<typename F>
+requires IsFileAllowWrite<F>
+class LogWriter
+{
+public:
+    explicit LogWriter(F&& logFile, const LogWriterOptions& writerOptions = {})
+        : file{std::move(logFile)}
+        , options{writerOptions}
+        , pending{std::make_shared<Batch>()}
+        , flusher{[this]{ flushLoop(); }}
+    {}
+
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator = (const LogWriter&) = delete;
+
+    // Records which are still pending are flushed before the writer goes away.
+    ~LogWriter()
+    {
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+        }
+        batchReady.notify_one();
+        flusher.join();
+    }
+
+    // Returns once the record is durable, or with the error of the write which carried it,
+    // or at once with the error of an earlier failed write.
+    Maybe<void> append(const std::span<const std::byte> record)
+    {
+        const auto submitted = Trace::Clock::now();
+        std::unique_lock lock{mutex};
+        if(ERROR_SUCCESS != failed)
+        {
+            ::SetLastError(failed);
+            return OccurredError{};
+        }
+        const std::shared_ptr<Batch> batch = pending;
+        if(batch->data.empty())
+        {
+            batch->opened = submitted;
+        }
+        batch->data.insert(batch->data.end(), record.begin(), record.end());
+        ++batch->records;
+        if(1u == batch->records || batch->data.size() >= static_cast<size_t>(options.batchSize))
+        {
+            batchReady.notify_one();
+        }
+
+        batchDone.wait(lock, [&]{ return batch->done; });
+        lock.unlock();
+
+        writerStats.commitLatency.record(Trace::Clock::now() - submitted);
+        if(ERROR_SUCCESS != batch->error)
+        {
+            ::SetLastError(batch->error);
+            return OccurredError{};
+        }
+        return {};
+    }
+
+    const LogWriterStats& stats() const noexcept
+    {
+        return writerStats;
+    }
+
+private:
+    struct Batch
+    {
+        std::vector<std::byte> data;
+        uint64_t records = 0u;
+        Trace::Clock::time_point opened;
+        bool done = false;
+        DWORD error = ERROR_SUCCESS;
+    };
+
+    void flushLoop()
+    {
+        std::unique_lock lock{mutex};
+        for(;;)
+        {
+            batchReady.wait(lock, [&]{ return stopping || !pending->data.empty(); });
+            if(pending->data.empty())
+            {
+                return;
+            }
+            batchReady.wait_until(lock, pending->opened + options.batchWindow, [&]
+            {
+                return stopping || pending->data.size() >= static_cast<size_t>(options.batchSize);
+            });
+
+            const std::shared_ptr<Batch> batch = std::exchange(pending, std::make_shared<Batch>());
+            if(ERROR_SUCCESS != failed)
+            {
+                // collected while the failed write ran, it must not land after the torn bytes
+                batch->error = failed;
+                batch->done = true;
+                batchDone.notify_all();
+                continue;
+            }
+            lock.unlock();
+            const DWORD error = write(batch->data);
+            lock.lock();
+
+            failed = error;
+            batch->error = error;
+            batch->done = true;
+            batchDone.notify_all();
+
+            writerStats.flushes.fetch_add(1u, std::memory_order_relaxed);
+            writerStats.records.fetch_add(batch->records, std::memory_order_relaxed);
+            writerStats.bytes.fetch_add(batch->data.size(), std::memory_order_relaxed);
+            if(batch->records > writerStats.largestFlush.load(std::memory_order_relaxed))
+            {
+                writerStats.largestFlush.store(batch->records, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    DWORD write(const std::vector<std::byte>& data)
+    {
+        const std::byte* begin = data.data();
+        const std::byte* const end = begin + data.size();
+        while(begin != end)
+        {
+            const auto written = static_cast<size_t>(fileWrite(file, begin, end));
+            if(0u == written)
+            {
+                const DWORD error = ::GetLastError();
+                return ERROR_SUCCESS != error ? error : ERROR_WRITE_FAULT;
+            }
+            begin += written;
+        }
+        if(options.syncData)
+        {
+            const auto synced = syncFileData(file);
+            if(!synced.okay())
+            {
+                return static_cast<DWORD>(synced.code().code().value());
+            }
+        }
+        return ERROR_SUCCESS;
+    }
+
+    F file;
+    const LogWriterOptions options;
+    LogWriterStats writerStats;
+
+    std::mutex mutex;
+    std::condition_variable batchReady;
+    std::condition_variable batchDone;
+    std::shared_ptr<Batch> pending;
+    DWORD failed = ERROR_SUCCESS;   // of the write which stopped the writer
+    bool stopping = false;
+
+    std::jthread flusher;
+
+}; // class LogWriter
+
+} // namespace WinApi::IO
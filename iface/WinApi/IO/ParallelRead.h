@@ -0,0 +1,111 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <WinApi/Sync/Event.h>
+#include <WinApi/Thread.h>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+struct FileChunk
+{
+    FileRange range;
+    std::span<std::byte> data;   // filled part of the destination buffer
+};
+
+using ChunkCallback = std::function<void(const FileChunk& chunk)>;
+
+struct ParallelReadOptions
+{
+    CountOfBytes  chunkSize = CountOfBytes{} + OneByte * (1u << 20);
+    size_t        workers   = std::thread::hardware_concurrency();
+    ChunkCallback onChunk   = {};   // called on the worker thread as soon as a chunk has landed
+    WorkerStart   onWorkerStart = {};   // e.g. pinWorkers(topology.spreadCpus())
+};
+
+// Reads `buffer.size()` bytes starting at `offset` into `buffer` with positional reads
+// on several threads. Chunk borders are aligned to `chunkSize` in file offsets, so chunks
+// of a FileFlag::NoBuffering handle stay sector aligned when `offset` is.
+// Open the file with FileFlag::Overllaped for the reads to run at once, the system runs
+// the reads of a synchronous handle one after another, see fileReadAtOverlapped.
+// Returns one result per chunk, in file order.
+template<typename F>
+requires IsFileAllowRead<F>
+std::vector<Maybe<CountOfBytes>> parallelReadFile(  const F& file
+                                                  , const std::span<std::byte> buffer
+                                                  , const CountOfBytes offset
+                                                  , const ParallelReadOptions& options = {} )
+{
+    const size_t chunkSize = std::max<size_t>(static_cast<size_t>(options.chunkSize), 1u);
+    const size_t begin = static_cast<size_t>(offset);
+    const size_t end = begin + buffer.size();
+
+    std::vector<FileRange> chunks;
+    for(size_t position = begin; position < end;)
+    {
+        const size_t next = std::min(end, (position / chunkSize + 1u) * chunkSize);
+        chunks.push_back(FileRange{CountOfBytes{} + OneByte * position, CountOfBytes{} + OneByte * (next - position)});
+        position = next;
+    }
+
+    std::vector<std::optional<Maybe<CountOfBytes>>> landed(chunks.size());
+
+    std::atomic<size_t> nextChunk{0u};
+    auto work = [&](const size_t worker)
+    {
+        std::optional<ThreadStateRestore> restore;
+        if(options.onWorkerStart)
+        {
+            if(0u == worker)
+            {
+                restore.emplace(); // the caller's own thread
+            }
+            options.onWorkerStart(worker);
+        }
+        const auto completion = Sync::createManualEvent();
+        for(size_t index = nextChunk++; index < chunks.size(); index = nextChunk++)
+        {
+            const FileRange& range = chunks[index];
+            if(!completion.okay())
+            {
+                landed[index].emplace(completion.code());
+                continue;
+            }
+            std::byte* const target = buffer.data() + (static_cast<size_t>(range.begin) - begin);
+            const auto& read = landed[index].emplace(fileReadAtOverlapped(file, range.begin, target, target + static_cast<size_t>(range.size), completion.value().get()));
+            if(read.okay() && options.onChunk)
+            {
+                options.onChunk(FileChunk{range, std::span{target, static_cast<size_t>(read.value())}});
+            }
+        }
+    };
+
+    const size_t workers = std::clamp<size_t>(options.workers, 1u, std::max<size_t>(chunks.size(), 1u));
+    std::vector<std::jthread> threads;
+    for(size_t worker = 1u; worker < workers; ++worker)
+    {
+        threads.emplace_back(work, worker);
+    }
+    work(0u);
+    threads.clear();
+
+    std::vector<Maybe<CountOfBytes>> results;
+    results.reserve(landed.size());
+    for(auto& read : landed)
+    {
+        results.push_back(std::move(*read));
+    }
+    return results;
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,59 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <Utils/RecordSplitter.h>
+#include <cstring>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+using Utils::RecordSplitter;
+
+// Streams the file from its current pointer through fileRead and calls `record`
+// for every record found. A record which straddles two reads is moved to the front
+// of the buffer and completed by the next read, the buffer grows for records longer than it.
+// The last record may be unterminated. Returns the number of bytes read.
+template<typename F, typename R>
+requires IsFileAllowRead<F>
+CountOfBytes fileReadRecords(  const F& file
+                             , const RecordSplitter& splitter
+                             , R&& record
+                             , const CountOfBytes bufferSize = CountOfBytes{} + OneByte * (1u << 20) )
+{
+    std::vector<std::byte> buffer(std::max<size_t>(static_cast<size_t>(bufferSize), 1u));
+    size_t carried = 0u;
+    CountOfBytes total{};
+    for(;;)
+    {
+        std::byte* const space = buffer.data() + carried;
+        const CountOfBytes read = fileRead(file, space, buffer.data() + buffer.size());
+        total += read - CountOfBytes{};
+
+        const size_t filled = carried + static_cast<size_t>(read);
+        const std::span<const std::byte> data{buffer.data(), filled};
+        if(filled < buffer.size())
+        {
+            splitter.splitAll(data, record); // end of file
+            break;
+        }
+
+        const auto tail = splitter.split(data, record);
+        carried = tail.size();
+        if(carried == buffer.size())
+        {
+            buffer.resize(buffer.size() * 2u);
+        }
+        else
+        {
+            std::memmove(buffer.data(), tail.data(), carried);
+        }
+    }
+    return total;
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,220 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/File.h>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+struct ScratchFileOptions
+{
+    CountOfBytes spillSize = CountOfBytes{} + OneByte * (1u << 20);  // kept in memory up to this size
+    std::filesystem::path directory;                                  // of the spilled file, the temp directory if empty
+};
+
+// Temporary file which lives in memory while it is small and moves to a Temporary,
+// DeleteOnClose file once it grows past spillSize. fileRead, fileWrite, setFilePointer
+// and the functions built on them accept it in place of a file, so scratch code does
+// not change. Like a file handle it is used by one thread at a time.
+class ScratchFile
+{
+    struct State
+    {
+        ScratchFileOptions options;
+        std::vector<std::byte> memory;
+        size_t position = 0u;
+        FileAccessReadWrite file;
+    };
+
+public:
+    ScratchFile() noexcept = default;
+
+    explicit ScratchFile(const ScratchFileOptions& options)
+        : state{std::make_unique<State>()}
+    {
+        state->options = options;
+    }
+
+    explicit operator bool () const noexcept
+    {
+        return static_cast<bool>(state);
+    }
+
+    bool spilled() const noexcept
+    {
+        return static_cast<bool>(state->file);
+    }
+
+    // Bytes written at [position, position + size), spilling first if the file would grow
+    // past spillSize. Fewer bytes when the spill fails.
+    CountOfBytes write(const std::byte* const data, const size_t size) const
+    {
+        if(!spilled() && state->position + size > static_cast<size_t>(state->options.spillSize) && !spill().okay())
+        {
+            return CountOfBytes{};
+        }
+        if(spilled())
+        {
+            return fileWrite(state->file, data, data + size);
+        }
+        if(state->memory.size() < state->position + size)
+        {
+            state->memory.resize(state->position + size);
+        }
+        std::memcpy(state->memory.data() + state->position, data, size);
+        state->position += size;
+        return CountOfBytes{} + OneByte * size;
+    }
+
+    CountOfBytes read(std::byte* const data, const size_t size) const
+    {
+        if(spilled())
+        {
+            return fileRead(state->file, data, data + size);
+        }
+        const size_t available = state->position < state->memory.size() ? state->memory.size() - state->position : 0u;
+        const size_t copied = std::min(size, available);
+        std::memcpy(data, state->memory.data() + state->position, copied);
+        state->position += copied;
+        return CountOfBytes{} + OneByte * copied;
+    }
+
+    Maybe<CountOfBytes> seek(const ptrdiff_t distance, const FilePointerFrom from) const
+    {
+        if(spilled())
+        {
+            return setFilePointer(state->file, OffsetOfBytes{} + OneByte * distance, from);
+        }
+        const ptrdiff_t base = FilePointerFrom::Begin == from ? 0
+                             : FilePointerFrom::Current == from ? static_cast<ptrdiff_t>(state->position)
+                             : static_cast<ptrdiff_t>(state->memory.size());
+        if(base + distance < 0)
+        {
+            ::SetLastError(ERROR_NEGATIVE_SEEK);
+            return OccurredError{};
+        }
+        state->position = static_cast<size_t>(base + distance);
+        return CountOfBytes{} + OneByte * state->position;
+    }
+
+    Maybe<CountOfBytes> size() const
+    {
+        if(spilled())
+        {
+            return getFileSize(state->file);
+        }
+        return CountOfBytes{} + OneByte * state->memory.size();
+    }
+
+private:
+    static std::filesystem::path spillPath(const std::filesystem::path& directory)
+    {
+        static std::atomic<uint64_t> spills{0u};
+        std::error_code error;
+        const std::filesystem::path parent = directory.empty() ? std::filesystem::temp_directory_path(error) : directory;
+        return parent / ("scratch-" + std::to_string(::GetCurrentProcessId()) + "-" + std::to_string(++spills));
+    }
+
+    Maybe<void> spill() const
+    {
+        WINAPI_TRACE_SCOPE(trace, "spillScratchFile");
+        auto file = createFile<DesiredAccess::GenericReadWrite>
+        (
+              spillPath(state->options.directory)
+            , ShareFlag::Delete
+            , CreateMode::CreateNew
+            , FileFlag::Temporary | FileFlag::DeleteOnClose
+        );
+        if(!file.okay())
+        {
+            trace.failed();
+            return Maybe<void>{file.code()};
+        }
+        const std::byte* const data = state->memory.data();
+        if(state->memory.size() != static_cast<size_t>(fileWrite(file.value(), data, data + state->memory.size())))
+        {
+            trace.failed();
+            return OccurredError{};
+        }
+        auto moved = setFilePointer(file.value(), OffsetOfBytes{} + OneByte * static_cast<ptrdiff_t>(state->position), FilePointerFrom::Begin);
+        if(!moved.okay())
+        {
+            trace.failed();
+            return Maybe<void>{moved.code()};
+        }
+        trace.bytes(state->memory.size());
+        state->file = std::move(file).value();
+        state->memory = std::vector<std::byte>{};
+        return {};
+    }
+
+    std::unique_ptr<State> state;
+
+}; // class ScratchFile
+
+static ScratchFile createScratchFile(const ScratchFileOptions& options = {})
+{
+    return ScratchFile{options};
+}
+
+
+template<typename I>
+requires std::is_trivially_copyable_v<I>
+CountOf<I> fileRead(const ScratchFile& file, I * const buffer_begin, const I * const buffer_end)
+{
+    const auto begin = reinterpret_cast<std::byte * >(buffer_begin);
+    const auto end   = reinterpret_cast<const std::byte * >(buffer_end);
+    return Utils::countOf<I>(file.read(begin, static_cast<size_t>(end - begin)));
+}
+
+template<typename I>
+requires std::is_trivially_copyable_v<I>
+CountOf<I> fileWrite(const ScratchFile& file, const I * const buffer_begin, const I * const buffer_end)
+{
+    const auto begin = reinterpret_cast<const std::byte * >(buffer_begin);
+    const auto end   = reinterpret_cast<const std::byte * >(buffer_end);
+    return Utils::countOf<I>(file.write(begin, static_cast<size_t>(end - begin)));
+}
+
+template<typename V>
+requires std::is_trivially_copyable_v<V>
+CountOf<V> fileReadValue(const ScratchFile& file, V& value)
+{
+    return fileRead(file, &value, &value + 1);
+}
+
+template<typename V>
+requires std::is_trivially_copyable_v<V>
+CountOf<V> fileWriteValue(const ScratchFile& file, const V& value)
+{
+    return fileWrite(file, &value, &value + 1);
+}
+
+template<typename I>
+Maybe<CountOf<I>> setFilePointer( const ScratchFile& file
+                                , const DiffOf<I> offset
+                                , const FilePointerFrom from = FilePointerFrom::Begin )
+{
+    auto position = file.seek(static_cast<ptrdiff_t>(Utils::offsetOf(offset)), from);
+    if(!position.okay())
+    {
+        return Maybe<CountOf<I>>{position.code()};
+    }
+    return Utils::countOf<I>(position.value());
+}
+
+static Maybe<CountOfBytes> getFileSize(const ScratchFile& file)
+{
+    return file.size();
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,34 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/FileMapping.h>
+
+
+namespace WinApi::IO
+{
+
+// Named segment backed by the paging file, visible to every process which knows the name.
+// If the segment already exists it is opened instead and GetLastError() is ERROR_ALREADY_EXISTS,
+// `size` is ignored then.
+static MaybeFileMapping createSharedMemory(const StringView& name, const CountOfBytes size)
+{
+    const ULARGE_INTEGER maxSize{.QuadPart = static_cast<size_t>(size)};
+    return fileMappingOf(::CreateFileMapping
+    (
+          INVALID_HANDLE_VALUE
+        , nullptr
+        , static_cast<DWORD>(PageProtection::ReadWrite)
+        , maxSize.HighPart
+        , maxSize.LowPart
+        , name.data()
+    ));
+}
+
+static MaybeFileMapping openSharedMemory(const StringView& name, const ViewAccess access = ViewAccess::ReadWrite)
+{
+    return fileMappingOf(::OpenFileMapping(static_cast<DWORD>(access), FALSE, name.data()));
+}
+
+} // namespace WinApi::IO
@@ -0,0 +1,289 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/IO/SharedMemory.h>
+#include <WinApi/Sync/Event.h>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <vector>
+
+
+namespace WinApi::IO
+{
+
+// Single producer, single consumer message ring in a named shared memory segment.
+// Messages are copied straight into the segment, the other side reads them in place.
+// The peer is woken through a named event only when it announced that it went to sleep,
+// so a busy channel makes no kernel calls at all.
+class SharedRing
+{
+public:
+    SharedRing() noexcept = default;
+    SharedRing(SharedRing&&) noexcept = default;
+
+    // Lays out a new ring of `capacity` bytes (rounded up to a power of two) in segment `name`.
+    static Maybe<SharedRing> create(const StringView& name, const CountOfBytes capacity)
+    {
+        const size_t ringSize = std::bit_ceil(std::max<size_t>(static_cast<size_t>(capacity), 64u));
+        auto maybeMapping = createSharedMemory(name, CountOfBytes{} + OneByte * (sizeof(Header) + ringSize));
+        if(!maybeMapping.okay())
+        {
+            return Maybe<SharedRing>{maybeMapping.code()};
+        }
+        if(ERROR_ALREADY_EXISTS == ::GetLastError())
+        {
+            return OccurredError{};
+        }
+        auto maybeView = mapViewOfFile
+        (
+              maybeMapping.value()
+            , ViewAccess::ReadWrite
+            , FileRange{CountOfBytes{}, CountOfBytes{} + OneByte * (sizeof(Header) + ringSize)}
+        );
+        if(!maybeView.okay())
+        {
+            return Maybe<SharedRing>{maybeView.code()};
+        }
+        Header* const header = new(maybeView.value().data.data()) Header{};
+        header->capacity = ringSize;
+        header->magic.store(Header::Magic, std::memory_order_release);
+        return attach(name, std::move(maybeMapping).value(), std::move(maybeView).value());
+    }
+
+    // Attaches to a ring which another process created.
+    static Maybe<SharedRing> open(const StringView& name)
+    {
+        auto maybeMapping = openSharedMemory(name);
+        if(!maybeMapping.okay())
+        {
+            return Maybe<SharedRing>{maybeMapping.code()};
+        }
+        const FileMapping& mapping = maybeMapping.value();
+
+        auto maybeHeader = mapViewOfFile(mapping, ViewAccess::ReadWrite, FileRange{CountOfBytes{}, CountOfBytes{} + OneByte * sizeof(Header)});
+        if(!maybeHeader.okay())
+        {
+            return Maybe<SharedRing>{maybeHeader.code()};
+        }
+        const Header& header = *reinterpret_cast<const Header*>(maybeHeader.value().data.data());
+        if(Header::Magic != header.magic.load(std::memory_order_acquire))
+        {
+            ::SetLastError(ERROR_INVALID_DATA);
+            return OccurredError{};
+        }
+
+        auto maybeView = mapViewOfFile
+        (
+              mapping
+            , ViewAccess::ReadWrite
+            , FileRange{CountOfBytes{}, CountOfBytes{} + OneByte * (sizeof(Header) + header.capacity)}
+        );
+        if(!maybeView.okay())
+        {
+            return Maybe<SharedRing>{maybeView.code()};
+        }
+        return attach(name, std::move(maybeMapping).value(), std::move(maybeView).value());
+    }
+
+    // The longest message which always fits, whatever the position of the ring.
+    size_t maxMessageSize() const noexcept
+    {
+        return capacity / 2u - LengthSize;
+    }
+
+    // Producer side. Returns false when the ring has no room for the message now.
+    bool tryWrite(const std::span<const std::byte> message) noexcept
+    {
+        const size_t need = recordSize(message.size());
+        const uint64_t head = header->head.load(std::memory_order_acquire);
+        uint64_t tail = header->tail.load(std::memory_order_relaxed);
+
+        const size_t offset = static_cast<size_t>(tail) & (capacity - 1u);
+        const size_t padding = capacity - offset < need ? capacity - offset : 0u;
+        if(tail + padding + need - head > capacity)
+        {
+            return false;
+        }
+        if(padding)
+        {
+            store(offset, WrapMarker);
+            tail += padding;
+        }
+        const size_t start = static_cast<size_t>(tail) & (capacity - 1u);
+        store(start, static_cast<uint32_t>(message.size()));
+        std::memcpy(ring + start + LengthSize, message.data(), message.size());
+        header->tail.store(tail + need, std::memory_order_release);
+
+        wake(header->readerSleeps, dataReady);
+        return true;
+    }
+
+    // Waits for room up to `timeout`, ERROR_TIMEOUT when there was none.
+    Maybe<void> write(const std::span<const std::byte> message, const Milliseconds timeout = Infinite)
+    {
+        if(message.size() > maxMessageSize())
+        {
+            ::SetLastError(ERROR_INSUFFICIENT_BUFFER);
+            return OccurredError{};
+        }
+        return waitUntil([&]{ return tryWrite(message); }, header->writerSleeps, spaceReady, timeout);
+    }
+
+    // Consumer side. Replaces the content of `message` with the next message, returns false if there is none.
+    bool tryRead(std::vector<std::byte>& message)
+    {
+        uint64_t head = header->head.load(std::memory_order_relaxed);
+        const uint64_t tail = header->tail.load(std::memory_order_acquire);
+        if(head == tail)
+        {
+            return false;
+        }
+        size_t start = static_cast<size_t>(head) & (capacity - 1u);
+        uint32_t length = load(start);
+        if(WrapMarker == length)
+        {
+            head += capacity - start;
+            start = 0u;
+            length = load(start);
+        }
+        message.assign(ring + start + LengthSize, ring + start + LengthSize + length);
+        header->head.store(head + recordSize(length), std::memory_order_release);
+
+        wake(header->writerSleeps, spaceReady);
+        return true;
+    }
+
+    Maybe<void> read(std::vector<std::byte>& message, const Milliseconds timeout = Infinite)
+    {
+        return waitUntil([&]{ return tryRead(message); }, header->readerSleeps, dataReady, timeout);
+    }
+
+private:
+    struct Header
+    {
+        static constexpr uint64_t Magic = 0x474E495252485357ull;
+
+        std::atomic<uint64_t> magic{0u};
+        uint64_t capacity = 0u;
+        alignas(64) std::atomic<uint64_t> head{0u};
+        std::atomic<uint32_t> writerSleeps{0u};
+        alignas(64) std::atomic<uint64_t> tail{0u};
+        std::atomic<uint32_t> readerSleeps{0u};
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    static constexpr size_t LengthSize = sizeof(uint32_t);
+    static constexpr uint32_t WrapMarker = ~uint32_t{0};
+
+    SharedRing(FileMapping&& ringMapping, FileView&& ringView, Sync::AutoEvent&& data, Sync::AutoEvent&& space) noexcept
+        : mapping{std::move(ringMapping)}
+        , view{std::move(ringView)}
+        , dataReady{std::move(data)}
+        , spaceReady{std::move(space)}
+        , header{reinterpret_cast<Header*>(view.data.data())}
+        , ring{view.data.data() + sizeof(Header)}
+        , capacity{static_cast<size_t>(header->capacity)}
+    {}
+
+    static Maybe<SharedRing> attach(const StringView& name, FileMapping&& mapping, FileView&& view)
+    {
+        auto maybeData = Sync::createAutoEvent(!Sync::EventSignaled, String{name} + TEXT(".data"));
+        if(!maybeData.okay())
+        {
+            return Maybe<SharedRing>{maybeData.code()};
+        }
+        auto maybeSpace = Sync::createAutoEvent(!Sync::EventSignaled, String{name} + TEXT(".space"));
+        if(!maybeSpace.okay())
+        {
+            return Maybe<SharedRing>{maybeSpace.code()};
+        }
+        return SharedRing{std::move(mapping), std::move(view), std::move(maybeData).value(), std::move(maybeSpace).value()};
+    }
+
+    static size_t recordSize(const size_t messageSize) noexcept
+    {
+        return (LengthSize + messageSize + 7u) & ~size_t{7u};
+    }
+
+    void store(const size_t offset, const uint32_t value) noexcept
+    {
+        std::memcpy(ring + offset, &value, sizeof(value));
+    }
+
+    uint32_t load(const size_t offset) const noexcept
+    {
+        uint32_t value = 0u;
+        std::memcpy(&value, ring + offset, sizeof(value));
+        return value;
+    }
+
+    // Pairs with the fence in waitUntil: either the sleeper sees our update or we see its flag.
+    static void wake(const std::atomic<uint32_t>& sleeps, const Sync::AutoEvent& event) noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(sleeps.load(std::memory_order_relaxed))
+        {
+            Sync::setEvent(event);
+        }
+    }
+
+    template<typename T>
+    static Maybe<void> waitUntil(T&& attempt, std::atomic<uint32_t>& sleeps, const Sync::AutoEvent& event, const Milliseconds timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for(;;)
+        {
+            if(attempt())
+            {
+                return {};
+            }
+            sleeps.store(1u, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(attempt())
+            {
+                sleeps.store(0u, std::memory_order_relaxed);
+                return {};
+            }
+
+            Milliseconds left = timeout;
+            if(Infinite != timeout)
+            {
+                const auto now = std::chrono::steady_clock::now();
+                left = now < deadline
+                     ? std::chrono::ceil<Milliseconds>(deadline - now)
+                     : Milliseconds{};
+            }
+            const auto status = waitFor(event, left);
+            sleeps.store(0u, std::memory_order_relaxed);
+            if(!status.okay())
+            {
+                return Maybe<void>{status.code()};
+            }
+            if(WaitStatus::Timeout == status.value())
+            {
+                if(attempt())
+                {
+                    return {};
+                }
+                ::SetLastError(ERROR_TIMEOUT);
+                return OccurredError{};
+            }
+        }
+    }
+
+    FileMapping mapping;
+    FileView view;
+    Sync::AutoEvent dataReady;
+    Sync::AutoEvent spaceReady;
+    Header* header = nullptr;
+    std::byte* ring = nullptr;
+    size_t capacity = 0u;
+
+}; // class SharedRing
+
+} // namespace WinApi::IO
@@ -0,0 +1,234 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Common.h>
+#include <WinApi/Handle.h>
+#include <WinApi/Trace.h>
+#include <Utils/CountOf.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+namespace WinApi
+{
+
+// Number of NUMA nodes, 1 where the query fails or the machine has a single node.
+static size_t numaNodeCount() noexcept
+{
+    ULONG highest = 0u;
+    if(FALSE == ::GetNumaHighestNodeNumber(&highest))
+    {
+        return 1u;
+    }
+    return static_cast<size_t>(highest) + 1u;
+}
+
+// Node of the processor the calling thread runs on right now, 0 if unknown.
+static USHORT currentNumaNode() noexcept
+{
+    PROCESSOR_NUMBER processor{};
+    ::GetCurrentProcessorNumberEx(&processor);
+    USHORT node = 0u;
+    if(FALSE == ::GetNumaProcessorNodeEx(&processor, &node) || MAXUSHORT == node)
+    {
+        return 0u;
+    }
+    return node;
+}
+
+
+// Heap of T objects whose memory is committed on one NUMA node. Memory comes in slabs
+// from VirtualAllocExNuma, freed objects are recycled and slabs are released with the heap,
+// so no instance may outlive it. When the node has no memory left the slab is taken
+// from any node instead of failing.
+template<typename T>
+class NumaHeap
+{
+    union Slot
+    {
+        Slot* next;
+        alignas(T) std::byte object[sizeof(T)];
+    };
+
+    struct State
+    {
+        DWORD node = 0u;
+        size_t slabSlots = 0u;
+
+        std::mutex mutex;
+        Slot* free = nullptr;
+        std::vector<Slot*> slabs;
+
+        ~State()
+        {
+            for(Slot* const slab : slabs)
+            {
+                ::VirtualFree(slab, 0u, MEM_RELEASE);
+            }
+        }
+    };
+
+public:
+    struct Deleter
+    {
+        State* state = nullptr;
+
+        void operator () (T* const instance) const noexcept
+        {
+            instance->~T();
+            Slot* const slot = reinterpret_cast<Slot*>(instance);
+            std::lock_guard lock{state->mutex};
+            slot->next = state->free;
+            state->free = slot;
+        }
+    };
+    using Instance = std::unique_ptr<T, Deleter>;
+
+    NumaHeap() noexcept = default;
+
+    NumaHeap(const DWORD node, const Utils::CountOf<T> slabCount)
+        : state{std::make_unique<State>()}
+    {
+        state->node = node;
+        state->slabSlots = std::max<size_t>(static_cast<size_t>(slabCount), 1u);
+    }
+
+    DWORD node() const noexcept
+    {
+        return state->node;
+    }
+
+    template<typename ...A>
+    Maybe<Instance> emplace(A&&... args)
+    {
+        WINAPI_TRACE_SCOPE(trace, "numaHeapEmplace");
+        Slot* const slot = allocate();
+        if(!slot)
+        {
+            trace.failed();
+            return OccurredError{};
+        }
+        trace.bytes(sizeof(T));
+        try
+        {
+            T* const instance = new(slot->object) T{std::forward<A>(args)...};
+            return Instance{instance, Deleter{state.get()}};
+        }
+        catch(...)
+        {
+            std::lock_guard lock{state->mutex};
+            slot->next = state->free;
+            state->free = slot;
+            throw;
+        }
+    }
+
+private:
+    Slot* allocate()
+    {
+        std::lock_guard lock{state->mutex};
+        if(!state->free)
+        {
+            const size_t size = state->slabSlots * sizeof(Slot);
+            void* slab = ::VirtualAllocExNuma
+            (
+                  ::GetCurrentProcess()
+                , nullptr
+                , size
+                , MEM_RESERVE | MEM_COMMIT
+                , PAGE_READWRITE
+                , state->node
+            );
+            if(!slab)
+            {
+                slab = ::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+            }
+            if(!slab)
+            {
+                return nullptr;
+            }
+            state->slabs.push_back(static_cast<Slot*>(slab));
+            Slot* const slots = static_cast<Slot*>(slab);
+            for(size_t index = state->slabSlots; index-- > 0u;)
+            {
+                slots[index].next = state->free;
+                state->free = &slots[index];
+            }
+        }
+        Slot* const slot = state->free;
+        state->free = slot->next;
+        return slot;
+    }
+
+    std::unique_ptr<State> state;
+
+}; // class NumaHeap
+
+template<typename T>
+Maybe<NumaHeap<T>> createNumaHeap(const DWORD node, const Utils::CountOf<T> slabCount = Utils::countOf<T>(Utils::CountOfBytes{} + Utils::OneByte * (64u << 10)))
+{
+    if(static_cast<size_t>(node) >= numaNodeCount())
+    {
+        ::SetLastError(ERROR_INVALID_PARAMETER);
+        return OccurredError{};
+    }
+    return NumaHeap<T>{node, slabCount};
+}
+
+template<typename T, typename ...A>
+auto numaHeapEmplace(NumaHeap<T>& heap, A&&... args)
+{
+    return heap.emplace(std::forward<A>(args)...);
+}
+
+
+// One NumaHeap per node, emplace allocates on the node of the calling thread.
+// On a single node machine it is just one NumaHeap.
+template<typename T>
+class NumaHeapSet
+{
+public:
+    using Instance = typename NumaHeap<T>::Instance;
+
+    explicit NumaHeapSet(const Utils::CountOf<T> slabCount = Utils::countOf<T>(Utils::CountOfBytes{} + Utils::OneByte * (64u << 10)))
+    {
+        const size_t nodes = numaNodeCount();
+        heaps.reserve(nodes);
+        for(size_t node = 0u; node < nodes; ++node)
+        {
+            heaps.emplace_back(static_cast<DWORD>(node), slabCount);
+        }
+    }
+
+    size_t nodes() const noexcept
+    {
+        return heaps.size();
+    }
+
+    NumaHeap<T>& local() noexcept
+    {
+        return heaps[std::min<size_t>(currentNumaNode(), heaps.size() - 1u)];
+    }
+
+    NumaHeap<T>& onNode(const size_t node) noexcept
+    {
+        return heaps[std::min(node, heaps.size() - 1u)];
+    }
+
+    template<typename ...A>
+    Maybe<Instance> emplace(A&&... args)
+    {
+        return local().emplace(std::forward<A>(args)...);
+    }
+
+private:
+    std::vector<NumaHeap<T>> heaps;
+
+}; // class NumaHeapSet
+
+} // namespace WinApi
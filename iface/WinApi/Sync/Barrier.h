@@ -0,0 +1,103 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Sync/Event.h>
+#include <atomic>
+
+
+namespace WinApi::Sync
+{
+
+// Reusable barrier for a fixed number of threads. Arrivals spin `spinCount` times
+// before they block, only the last one wakes the others.
+class Barrier
+{
+public:
+    explicit Barrier(const LONG threads, const LONG spinCount = -1) noexcept
+    {
+        ::InitializeSynchronizationBarrier(&barrier, threads, spinCount);
+    }
+
+    Barrier(const Barrier&) = delete;
+    Barrier& operator = (const Barrier&) = delete;
+
+    ~Barrier()
+    {
+        ::DeleteSynchronizationBarrier(&barrier);
+    }
+
+    // True in exactly one of the threads of every phase.
+    bool arriveAndWait() noexcept
+    {
+        return FALSE != ::EnterSynchronizationBarrier(&barrier, 0u);
+    }
+
+private:
+    SYNCHRONIZATION_BARRIER barrier;
+
+}; // class Barrier
+
+
+// Single use countdown for joining a fan-out. Counting down is a user space atomic,
+// only the arrival which reaches zero sets the event, so the join costs one wake.
+// The event can also be passed to waitFor along with other handles.
+class Latch
+{
+public:
+    static Maybe<Latch> create(const ptrdiff_t expected)
+    {
+        auto event = createManualEvent(0 == expected ? EventSignaled : !EventSignaled);
+        if(!event.okay())
+        {
+            return Maybe<Latch>{event.code()};
+        }
+        return Latch{expected, std::move(event).value()};
+    }
+
+    Latch() noexcept = default;
+    Latch(Latch&& other) noexcept
+        : count{other.count.load(std::memory_order_relaxed)}
+        , done{std::move(other.done)}
+    {}
+
+    // The arrival which reaches zero touches nothing but the event afterwards.
+    Maybe<void> countDown(const ptrdiff_t arrivals = 1)
+    {
+        if(arrivals == count.fetch_sub(arrivals, std::memory_order_acq_rel))
+        {
+            return setEvent(done);
+        }
+        return {};
+    }
+
+    // Waiters go by the event rather than the count, so the latch may be destroyed
+    // as soon as they return, even though the last arrival is still in setEvent.
+    bool tryWait() const noexcept
+    {
+        return WAIT_OBJECT_0 == ::WaitForSingleObjectEx(done.get(), 0u, FALSE);
+    }
+
+    Maybe<WaitStatus> wait(const Milliseconds timeout = Infinite) const
+    {
+        return waitFor(done, timeout);
+    }
+
+    const ManualEvent& event() const noexcept
+    {
+        return done;
+    }
+
+private:
+    Latch(const ptrdiff_t expected, ManualEvent&& event) noexcept
+        : count{expected}
+        , done{std::move(event)}
+    {}
+
+    std::atomic<ptrdiff_t> count{0};
+    ManualEvent done;
+
+}; // class Latch
+
+} // namespace WinApi::Sync
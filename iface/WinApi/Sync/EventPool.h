@@ -0,0 +1,241 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Sync/Event.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace WinApi::Sync
+{
+
+struct EventPoolOptions
+{
+    size_t highWaterMark = 1024u;   // idle events kept in the free list and thread caches, the rest is closed
+    size_t threadCache   = 16u;     // idle events kept by every thread in front of the free list
+};
+
+// Hands out unnamed events and takes them back reset, so a request costs no kernel object
+// creation. Released events first go to a cache of the releasing thread, which needs
+// no lock, and then to the shared free list. The pool keeps track of the thread caches
+// and closes the events in them when it is destroyed, a thread closes its own when it exits.
+// Every Pooled must be released before its pool is destroyed, and no thread may use
+// the pool meanwhile.
+template<EventReset Mode>
+class BasicEventPool
+{
+public:
+    using PoolEvent = Event<Mode>;
+
+    // Must not outlive its pool, it returns the event there.
+    struct Pooled
+    {
+        Pooled() noexcept = default;
+
+        Pooled(BasicEventPool& eventPool, PoolEvent&& pooledEvent) noexcept
+            : pool{&eventPool}
+            , event{std::move(pooledEvent)}
+        {}
+
+        Pooled(Pooled&& other) noexcept
+            : pool{std::exchange(other.pool, nullptr)}
+            , event{std::move(other.event)}
+        {}
+
+        Pooled& operator = (Pooled&& other) noexcept
+        {
+            if(this != &other)
+            {
+                release();
+                pool = std::exchange(other.pool, nullptr);
+                event = std::move(other.event);
+            }
+            return *this;
+        }
+
+        ~Pooled()
+        {
+            release();
+        }
+
+        const PoolEvent& get() const noexcept
+        {
+            return event;
+        }
+
+        void release() noexcept
+        {
+            if(BasicEventPool* const owner = std::exchange(pool, nullptr))
+            {
+                owner->release(std::move(event));
+            }
+        }
+
+    private:
+        BasicEventPool* pool = nullptr;
+        PoolEvent event;
+
+    }; // struct Pooled
+
+    explicit BasicEventPool(const EventPoolOptions& poolOptions = {})
+        : options{poolOptions}
+        , id{nextPoolId()}
+    {}
+
+    BasicEventPool(const BasicEventPool&) = delete;
+    BasicEventPool& operator = (const BasicEventPool&) = delete;
+
+    ~BasicEventPool()
+    {
+        // no thread uses the pool any more, so none touches its cache meanwhile
+        for(const auto& registered : caches)
+        {
+            if(const auto cache = registered.lock())
+            {
+                cache->events.clear();
+            }
+        }
+    }
+
+    // The event is not signaled.
+    Maybe<Pooled> acquire()
+    {
+        std::vector<PoolEvent>& cache = threadCache();
+        if(!cache.empty())
+        {
+            PoolEvent event = std::move(cache.back());
+            cache.pop_back();
+            idle->fetch_sub(1u, std::memory_order_relaxed);
+            return Pooled{*this, std::move(event)};
+        }
+        {
+            std::lock_guard lock{mutex};
+            if(!free.empty())
+            {
+                PoolEvent event = std::move(free.back());
+                free.pop_back();
+                idle->fetch_sub(1u, std::memory_order_relaxed);
+                return Pooled{*this, std::move(event)};
+            }
+        }
+
+        auto event = createEvent<Mode>();
+        if(!event.okay())
+        {
+            return Maybe<Pooled>{event.code()};
+        }
+        created.fetch_add(1u, std::memory_order_relaxed);
+        return Pooled{*this, std::move(event).value()};
+    }
+
+    // Number of events the pool created, each one is a kernel call.
+    size_t createdEvents() const noexcept
+    {
+        return created.load(std::memory_order_relaxed);
+    }
+
+    // Events in the free list and in the thread caches.
+    size_t idleEvents() const noexcept
+    {
+        return idle->load(std::memory_order_relaxed);
+    }
+
+private:
+    static uint64_t nextPoolId() noexcept
+    {
+        static std::atomic<uint64_t> last{0u};
+        return ++last;
+    }
+
+    using IdleCount = std::atomic<size_t>;
+
+    // Events one thread keeps for one pool, still counted by the pool while it exists.
+    struct CachedEvents
+    {
+        CachedEvents(const std::shared_ptr<IdleCount>& pool) noexcept
+            : idle{pool}
+        {}
+
+        CachedEvents(const CachedEvents&) = delete;
+        CachedEvents& operator = (const CachedEvents&) = delete;
+
+        ~CachedEvents()
+        {
+            if(const auto count = idle.lock())
+            {
+                count->fetch_sub(events.size(), std::memory_order_relaxed);
+            }
+        }
+
+        std::weak_ptr<IdleCount> idle;  // expires with the pool
+        std::vector<PoolEvent> events;
+    };
+
+    // Owned by the thread, the pool only registers it to empty it on destruction.
+    std::vector<PoolEvent>& threadCache()
+    {
+        static thread_local std::unordered_map<uint64_t, std::shared_ptr<CachedEvents>> threadCaches;
+        auto found = threadCaches.find(id);
+        if(found == threadCaches.end())
+        {
+            std::erase_if(threadCaches, [](const auto& cached){ return cached.second->idle.expired(); });
+            auto cache = std::make_shared<CachedEvents>(idle);
+            {
+                std::lock_guard lock{mutex};
+                std::erase_if(caches, [](const auto& registered){ return registered.expired(); });
+                caches.push_back(cache);
+            }
+            found = threadCaches.emplace(id, std::move(cache)).first;
+        }
+        return found->second->events;
+    }
+
+    void release(PoolEvent&& event) noexcept
+    {
+        if(!resetEvent(event).okay())
+        {
+            return; // a broken event is closed instead of being handed out again
+        }
+        if(idle->fetch_add(1u, std::memory_order_relaxed) >= options.highWaterMark)
+        {
+            idle->fetch_sub(1u, std::memory_order_relaxed);
+            return;
+        }
+        try
+        {
+            std::vector<PoolEvent>& cache = threadCache();
+            if(cache.size() < options.threadCache)
+            {
+                cache.push_back(std::move(event));
+                return;
+            }
+            std::lock_guard lock{mutex};
+            free.push_back(std::move(event));
+        }
+        catch(...)
+        {
+            idle->fetch_sub(1u, std::memory_order_relaxed); // out of memory, the event is closed
+        }
+    }
+
+    const EventPoolOptions options;
+    const uint64_t id;
+    const std::shared_ptr<IdleCount> idle = std::make_shared<IdleCount>(0u);
+    std::atomic<size_t> created{0u};
+
+    std::mutex mutex;
+    std::vector<PoolEvent> free;
+    std::vector<std::weak_ptr<CachedEvents>> caches;    // of the threads which used the pool
+
+}; // class BasicEventPool
+
+using ManualEventPool = BasicEventPool<EventReset::Manual>;
+using AutoEventPool   = BasicEventPool<EventReset::Auto>;
+
+} // namespace WinApi::Sync
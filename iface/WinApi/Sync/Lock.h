@@ -0,0 +1,235 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Common.h>
+#include <WinApi/Trace.h>
+#include <synchapi.h>
+#include <atomic>
+#include <type_traits>
+
+
+namespace WinApi::Sync
+{
+
+struct LockStats
+{
+    std::atomic<uint64_t> acquisitions{0u};
+    std::atomic<uint64_t> contended{0u};     // acquisitions which found the lock taken
+    std::atomic<uint64_t> waitTime{0u};      // nanoseconds spent in contended acquisitions
+    Trace::Histogram waits;
+
+    void acquired() noexcept
+    {
+        acquisitions.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    void waited(const Trace::Nanoseconds time) noexcept
+    {
+        acquisitions.fetch_add(1u, std::memory_order_relaxed);
+        contended.fetch_add(1u, std::memory_order_relaxed);
+        waitTime.fetch_add(static_cast<uint64_t>(time.count()), std::memory_order_relaxed);
+        waits.record(time);
+    }
+
+    void reset() noexcept
+    {
+        acquisitions.store(0u, std::memory_order_relaxed);
+        contended.store(0u, std::memory_order_relaxed);
+        waitTime.store(0u, std::memory_order_relaxed);
+        waits.reset();
+    }
+};
+
+struct NoLockStats
+{};
+
+// Acquires with `attempt` if it succeeds within `spins` retries, else parks through `park`.
+// Only a failed first attempt counts as contention.
+template<typename S, typename T, typename P>
+void spinThenPark(const DWORD spins, S& stats, T&& attempt, P&& park)
+{
+    constexpr bool Counted = std::is_same_v<S, LockStats>;
+    if(attempt())
+    {
+        if constexpr(Counted)
+        {
+            stats.acquired();
+        }
+        return;
+    }
+
+    [[maybe_unused]] const auto start = Counted ? Trace::Clock::now() : Trace::Clock::time_point{};
+    bool acquired = false;
+    for(DWORD spin = 0u; spin < spins && !acquired; ++spin)
+    {
+        ::YieldProcessor();
+        acquired = attempt();
+    }
+    if(!acquired)
+    {
+        park();
+    }
+    if constexpr(Counted)
+    {
+        stats.waited(Trace::Clock::now() - start);
+    }
+}
+
+
+// Slim reader/writer lock, meets the Lockable and SharedLockable requirements so it works
+// with std::unique_lock and std::shared_lock. It is not recursive. `spinCount` is the number
+// of try-acquires before the thread parks in the kernel.
+template<bool Counted>
+class BasicSrwLock
+{
+public:
+    explicit BasicSrwLock(const DWORD spinCount = 0u) noexcept
+        : spins{spinCount}
+    {}
+
+    BasicSrwLock(const BasicSrwLock&) = delete;
+    BasicSrwLock& operator = (const BasicSrwLock&) = delete;
+
+    void lock() noexcept
+    {
+        spinThenPark(spins, lockStats
+            , [this]{ return FALSE != ::TryAcquireSRWLockExclusive(&srw); }
+            , [this]{ ::AcquireSRWLockExclusive(&srw); });
+    }
+
+    bool try_lock() noexcept
+    {
+        const bool locked = FALSE != ::TryAcquireSRWLockExclusive(&srw);
+        if constexpr(Counted)
+        {
+            if(locked)
+            {
+                lockStats.acquired();
+            }
+        }
+        return locked;
+    }
+
+    void unlock() noexcept
+    {
+        ::ReleaseSRWLockExclusive(&srw);
+    }
+
+    void lock_shared() noexcept
+    {
+        spinThenPark(spins, lockStats
+            , [this]{ return FALSE != ::TryAcquireSRWLockShared(&srw); }
+            , [this]{ ::AcquireSRWLockShared(&srw); });
+    }
+
+    bool try_lock_shared() noexcept
+    {
+        const bool locked = FALSE != ::TryAcquireSRWLockShared(&srw);
+        if constexpr(Counted)
+        {
+            if(locked)
+            {
+                lockStats.acquired();
+            }
+        }
+        return locked;
+    }
+
+    void unlock_shared() noexcept
+    {
+        ::ReleaseSRWLockShared(&srw);
+    }
+
+    const LockStats& stats() const noexcept requires Counted
+    {
+        return lockStats;
+    }
+
+    PSRWLOCK native() noexcept
+    {
+        return &srw;
+    }
+
+private:
+    SRWLOCK srw = SRWLOCK_INIT;
+    const DWORD spins;
+    [[no_unique_address]] std::conditional_t<Counted, LockStats, NoLockStats> lockStats;
+
+}; // class BasicSrwLock
+
+using SrwLock        = BasicSrwLock<false>;
+using CountedSrwLock = BasicSrwLock<true>;
+
+
+// Recursive lock, the kernel spins `spinCount` times on multiprocessor systems before it waits.
+template<bool Counted>
+class BasicCriticalSection
+{
+public:
+    explicit BasicCriticalSection(const DWORD spinCount = 4000u) noexcept
+    {
+        ::InitializeCriticalSectionAndSpinCount(&section, spinCount);
+    }
+
+    BasicCriticalSection(const BasicCriticalSection&) = delete;
+    BasicCriticalSection& operator = (const BasicCriticalSection&) = delete;
+
+    ~BasicCriticalSection()
+    {
+        ::DeleteCriticalSection(&section);
+    }
+
+    void lock() noexcept
+    {
+        if constexpr(Counted)
+        {
+            spinThenPark(0u, lockStats
+                , [this]{ return FALSE != ::TryEnterCriticalSection(&section); }
+                , [this]{ ::EnterCriticalSection(&section); });
+        }
+        else
+        {
+            ::EnterCriticalSection(&section);
+        }
+    }
+
+    bool try_lock() noexcept
+    {
+        const bool locked = FALSE != ::TryEnterCriticalSection(&section);
+        if constexpr(Counted)
+        {
+            if(locked)
+            {
+                lockStats.acquired();
+            }
+        }
+        return locked;
+    }
+
+    void unlock() noexcept
+    {
+        ::LeaveCriticalSection(&section);
+    }
+
+    DWORD setSpinCount(const DWORD spinCount) noexcept
+    {
+        return ::SetCriticalSectionSpinCount(&section, spinCount);
+    }
+
+    const LockStats& stats() const noexcept requires Counted
+    {
+        return lockStats;
+    }
+
+private:
+    CRITICAL_SECTION section;
+    [[no_unique_address]] std::conditional_t<Counted, LockStats, NoLockStats> lockStats;
+
+}; // class BasicCriticalSection
+
+using CriticalSection        = BasicCriticalSection<false>;
+using CountedCriticalSection = BasicCriticalSection<true>;
+
+} // namespace WinApi::Sync
@@ -0,0 +1,52 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Common.h>
+#include <WinApi/Handle.h>
+#include <synchapi.h>
+#include <limits>
+
+
+namespace WinApi::Sync
+{
+
+// Counting semaphore. It is a kernel object, so waitFor acquires one unit and
+// several processes can share it through `name`.
+static auto createSemaphore(  const LONG initial
+                            , const LONG maximum = std::numeric_limits<LONG>::max()
+                            , const StringView& name = {} )
+{
+    const HANDLE handle = ::CreateSemaphore(nullptr, initial, maximum, name.data());
+    auto semaphore = safeHandle(handle, [](const HANDLE handle)
+    {
+        if(handle)
+        {
+            ::CloseHandle(handle);
+        }
+    });
+    using Result = decltype(semaphore);
+
+    if(!semaphore)
+    {
+        return Maybe<Result>{OccurredError{}};
+    }
+    return Maybe<Result>{std::move(semaphore)};
+}
+
+using MaybeSemaphore = decltype(createSemaphore(0));
+using Semaphore = typename MaybeSemaphore::Type;
+
+// Returns the count before the release. ERROR_TOO_MANY_POSTS past the maximum.
+static Maybe<LONG> releaseSemaphore(const Semaphore& semaphore, const LONG count = 1)
+{
+    LONG previous = 0;
+    if(FALSE == ::ReleaseSemaphore(semaphore.get(), count, &previous))
+    {
+        return OccurredError{};
+    }
+    return LONG{previous};
+}
+
+} // namespace WinApi::Sync
@@ -0,0 +1,134 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Common.h>
+#include <WinApi/Topology.h>
+#include <functional>
+#include <optional>
+#include <vector>
+
+
+namespace WinApi
+{
+
+enum class ThreadPriority: int
+{
+      Idle         = THREAD_PRIORITY_IDLE
+    , Lowest       = THREAD_PRIORITY_LOWEST
+    , BelowNormal  = THREAD_PRIORITY_BELOW_NORMAL
+    , Normal       = THREAD_PRIORITY_NORMAL
+    , AboveNormal  = THREAD_PRIORITY_ABOVE_NORMAL
+    , Highest      = THREAD_PRIORITY_HIGHEST
+    , TimeCritical = THREAD_PRIORITY_TIME_CRITICAL
+};
+
+// `thread` is any thread handle, e.g. std::thread::native_handle(), or ::GetCurrentThread().
+static Maybe<void> setThreadPriority(const HANDLE thread, const ThreadPriority priority)
+{
+    if(FALSE == ::SetThreadPriority(thread, static_cast<int>(priority)))
+    {
+        return OccurredError{};
+    }
+    return {};
+}
+
+static Maybe<ThreadPriority> getThreadPriority(const HANDLE thread)
+{
+    const int priority = ::GetThreadPriority(thread);
+    if(THREAD_PRIORITY_ERROR_RETURN == priority)
+    {
+        return OccurredError{};
+    }
+    return static_cast<ThreadPriority>(priority);
+}
+
+// Returns the previous affinity.
+static Maybe<CpuSet> setThreadAffinity(const HANDLE thread, const CpuSet& cpus)
+{
+    CpuSet previous{};
+    if(FALSE == ::SetThreadGroupAffinity(thread, &cpus, &previous))
+    {
+        return OccurredError{};
+    }
+    return std::move(previous);
+}
+
+static Maybe<CpuSet> getThreadAffinity(const HANDLE thread)
+{
+    CpuSet cpus{};
+    if(FALSE == ::GetThreadGroupAffinity(thread, &cpus))
+    {
+        return OccurredError{};
+    }
+    return std::move(cpus);
+}
+
+static Maybe<void> setCurrentThreadPriority(const ThreadPriority priority)
+{
+    return setThreadPriority(::GetCurrentThread(), priority);
+}
+
+static Maybe<CpuSet> setCurrentThreadAffinity(const CpuSet& cpus)
+{
+    return setThreadAffinity(::GetCurrentThread(), cpus);
+}
+
+
+// Puts the affinity and priority of the calling thread back as they were when
+// it was constructed.
+class ThreadStateRestore
+{
+public:
+    ThreadStateRestore()
+        : affinity{getThreadAffinity(::GetCurrentThread())}
+        , priority{getThreadPriority(::GetCurrentThread())}
+    {}
+
+    ThreadStateRestore(const ThreadStateRestore&) = delete;
+    ThreadStateRestore& operator = (const ThreadStateRestore&) = delete;
+
+    ~ThreadStateRestore()
+    {
+        if(affinity.okay())
+        {
+            setCurrentThreadAffinity(affinity.value());
+        }
+        if(priority.okay())
+        {
+            setCurrentThreadPriority(priority.value());
+        }
+    }
+
+private:
+    const Maybe<CpuSet> affinity;
+    const Maybe<ThreadPriority> priority;
+
+}; // class ThreadStateRestore
+
+
+// Called first thing on every worker thread of the library's thread pools
+// (walkDirectory, parallelReadFile). Worker 0 is the calling thread itself,
+// its affinity and priority are restored once it has done its share.
+using WorkerStart = std::function<void(size_t worker)>;
+
+// Pins worker i to cpus[i % cpus.size()], e.g. Topology::spreadCpus() or nodeCpus(node).
+// Failures are ignored, the worker then runs wherever the scheduler puts it.
+static WorkerStart pinWorkers(  std::vector<CpuSet> cpus
+                              , const std::optional<ThreadPriority> priority = std::nullopt )
+{
+    return [cpus = std::move(cpus), priority](const size_t worker)
+    {
+        if(!cpus.empty())
+        {
+            setCurrentThreadAffinity(cpus[worker % cpus.size()]);
+        }
+        if(priority)
+        {
+            setCurrentThreadPriority(*priority);
+        }
+    };
+}
+
+} // namespace WinApi
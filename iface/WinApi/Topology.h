@@ -0,0 +1,191 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Common.h>
+#include <Utils/CountOf.h>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+
+namespace WinApi
+{
+
+// Logical processors are addressed by processor group and a mask within the group.
+using CpuSet = GROUP_AFFINITY;
+
+static constexpr bool intersects(const CpuSet& first, const CpuSet& second) noexcept
+{
+    return first.Group == second.Group && 0u != (first.Mask & second.Mask);
+}
+
+static constexpr size_t cpuCount(const CpuSet& cpus) noexcept
+{
+    return static_cast<size_t>(std::popcount(static_cast<uint64_t>(cpus.Mask)));
+}
+
+enum class CacheType: BYTE
+{
+      Unified     = CacheUnified
+    , Instruction = CacheInstruction
+    , Data        = CacheData
+    , Trace       = CacheTrace
+};
+
+struct CpuCore
+{
+    CpuSet cpus;                // one bit per logical processor, several with SMT
+    BYTE efficiencyClass = 0u;  // higher is faster on hybrid processors
+    size_t package = 0u;        // index into Topology::packages
+    size_t node = 0u;           // index into Topology::nodes
+};
+
+struct CpuPackage
+{
+    std::vector<CpuSet> cpus;
+};
+
+struct NumaNode
+{
+    DWORD number = 0u;
+    CpuSet cpus;
+};
+
+struct CpuCache
+{
+    BYTE level = 0u;
+    CacheType type = CacheType::Unified;
+    Utils::CountOfBytes size;
+    WORD lineSize = 0u;
+    CpuSet cpus;                // processors sharing the cache
+};
+
+struct Topology
+{
+    std::vector<CpuCore> cores;
+    std::vector<CpuPackage> packages;
+    std::vector<NumaNode> nodes;
+    std::vector<CpuCache> caches;
+
+    size_t logicalProcessors() const noexcept
+    {
+        size_t count = 0u;
+        for(const CpuCore& core : cores)
+        {
+            count += cpuCount(core.cpus);
+        }
+        return count;
+    }
+
+    // One logical processor per core first, the SMT siblings after them,
+    // the order in which workers spread best.
+    std::vector<CpuSet> spreadCpus() const
+    {
+        std::vector<CpuSet> spread;
+        for(size_t sibling = 0u; spread.size() < logicalProcessors(); ++sibling)
+        {
+            for(const CpuCore& core : cores)
+            {
+                KAFFINITY mask = core.cpus.Mask;
+                for(size_t skip = 0u; skip < sibling && mask; ++skip)
+                {
+                    mask &= mask - 1u;
+                }
+                if(mask)
+                {
+                    CpuSet cpu{};
+                    cpu.Group = core.cpus.Group;
+                    cpu.Mask = mask & (~mask + 1u);
+                    spread.push_back(cpu);
+                }
+            }
+        }
+        return spread;
+    }
+
+    std::vector<CpuSet> nodeCpus(const size_t node) const
+    {
+        std::vector<CpuSet> cpus;
+        for(const CpuSet& cpu : spreadCpus())
+        {
+            if(intersects(cpu, nodes[node].cpus))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+};
+
+// Cores, packages, NUMA nodes and caches of all processor groups of the machine.
+static Maybe<Topology> queryTopology()
+{
+    DWORD size = 0u;
+    if(FALSE == ::GetLogicalProcessorInformationEx(RelationAll, nullptr, &size)
+       && ERROR_INSUFFICIENT_BUFFER != ::GetLastError())
+    {
+        return OccurredError{};
+    }
+    std::vector<std::byte> buffer(size);
+    auto* const first = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+    if(FALSE == ::GetLogicalProcessorInformationEx(RelationAll, first, &size))
+    {
+        return OccurredError{};
+    }
+
+    Topology topology;
+    for(size_t offset = 0u; offset < size;)
+    {
+        const auto& info = *reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+        switch(info.Relationship)
+        {
+        case RelationProcessorCore:
+            topology.cores.push_back(CpuCore{info.Processor.GroupMask[0], info.Processor.EfficiencyClass});
+            break;
+        case RelationProcessorPackage:
+            topology.packages.emplace_back(CpuPackage{{info.Processor.GroupMask, info.Processor.GroupMask + info.Processor.GroupCount}});
+            break;
+        case RelationNumaNode:
+            topology.nodes.push_back(NumaNode{info.NumaNode.NodeNumber, info.NumaNode.GroupMask});
+            break;
+        case RelationCache:
+            topology.caches.push_back(CpuCache
+            {
+                  info.Cache.Level
+                , static_cast<CacheType>(info.Cache.Type)
+                , Utils::CountOfBytes{} + Utils::OneByte * info.Cache.CacheSize
+                , info.Cache.LineSize
+                , info.Cache.GroupMask
+            });
+            break;
+        default:
+            break;
+        }
+        offset += info.Size;
+    }
+
+    for(CpuCore& core : topology.cores)
+    {
+        for(size_t package = 0u; package < topology.packages.size(); ++package)
+        {
+            const auto& cpus = topology.packages[package].cpus;
+            if(std::any_of(cpus.begin(), cpus.end(), [&](const CpuSet& set){ return intersects(set, core.cpus); }))
+            {
+                core.package = package;
+            }
+        }
+        for(size_t node = 0u; node < topology.nodes.size(); ++node)
+        {
+            if(intersects(topology.nodes[node].cpus, core.cpus))
+            {
+                core.node = node;
+            }
+        }
+    }
+    return std::move(topology);
+}
+
+} // namespace WinApi
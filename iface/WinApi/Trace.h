@@ -0,0 +1,393 @@
+#pragma once
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <WinApi/Common.h>
+#include <atomic>
+#include <array>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+
+
+// Define CPP_WIN_API_TRACE to record call counts, bytes and latencies
+// of the wrapped system calls. Without it WINAPI_TRACE_SCOPE is an empty object.
+#if defined(CPP_WIN_API_TRACE)
+#define WINAPI_TRACE_SCOPE(scope, name)                               \
+    static ::WinApi::Trace::Site& scope##Site                         \
+        = ::WinApi::Trace::Site::named(name);                         \
+    ::WinApi::Trace::Scope scope{scope##Site}
+#else
+#define WINAPI_TRACE_SCOPE(scope, name)                               \
+    [[maybe_unused]] ::WinApi::Trace::Scope scope{}
+#endif
+
+
+namespace WinApi::Trace
+{
+
+#if defined(CPP_WIN_API_TRACE)
+static constexpr bool Enabled = true;
+#else
+static constexpr bool Enabled = false;
+#endif
+
+using Clock       = std::chrono::steady_clock;
+using Nanoseconds = std::chrono::nanoseconds;
+
+
+// Bucket i counts latencies in [2^i, 2^(i+1)) nanoseconds.
+struct Histogram
+{
+    static constexpr size_t Buckets = 48;
+
+    static constexpr size_t bucketOf(const Nanoseconds latency) noexcept
+    {
+        const auto ticks = static_cast<uint64_t>(latency.count() > 0 ? latency.count() : 0);
+        const size_t bucket = ticks ? static_cast<size_t>(std::bit_width(ticks)) - 1u : 0u;
+        return bucket < Buckets ? bucket : Buckets - 1u;
+    }
+
+    static constexpr Nanoseconds lowerBound(const size_t bucket) noexcept
+    {
+        return Nanoseconds{bucket ? (int64_t{1} << bucket) : 0};
+    }
+
+    void record(const Nanoseconds latency) noexcept
+    {
+        counts[bucketOf(latency)].fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    uint64_t count(const size_t bucket) const noexcept
+    {
+        return counts[bucket].load(std::memory_order_relaxed);
+    }
+
+    // Lower bound of the bucket holding the given fraction of samples.
+    Nanoseconds percentile(const double fraction) const noexcept
+    {
+        uint64_t total = 0u;
+        for(const auto& counter : counts)
+        {
+            total += counter.load(std::memory_order_relaxed);
+        }
+        const auto wanted = static_cast<uint64_t>(static_cast<double>(total) * fraction);
+        uint64_t seen = 0u;
+        for(size_t bucket = 0u; bucket < Buckets; ++bucket)
+        {
+            seen += count(bucket);
+            if(seen > wanted)
+            {
+                return lowerBound(bucket);
+            }
+        }
+        return lowerBound(Buckets - 1u);
+    }
+
+    void reset() noexcept
+    {
+        for(auto& counter : counts)
+        {
+            counter.store(0u, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, Buckets> counts{};
+
+}; // struct Histogram
+
+
+// One traced call site. Sites register themselves in a process wide list
+// on first use and are never unregistered.
+// WINAPI_TRACE_SCOPE takes its site by name, so all instantiations of a template
+// and all places tracing under one name count together.
+struct Site
+{
+    explicit Site(const std::string_view siteName) noexcept
+        : name{siteName}
+        , next{head().load(std::memory_order_relaxed)}
+    {
+        while(!head().compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed))
+        {}
+    }
+
+    Site(const Site&) = delete;
+    Site& operator = (const Site&) = delete;
+
+    // The registered site with this name, created on the first call for it.
+    static Site& named(const std::string_view siteName)
+    {
+        static std::mutex creating;
+        std::lock_guard lock{creating};
+        for(Site* site = head().load(std::memory_order_acquire); site; site = site->next)
+        {
+            if(site->name == siteName)
+            {
+                return *site;
+            }
+        }
+        return *new Site{siteName}; // lives as long as the list
+    }
+
+    void record(const Nanoseconds latency, const uint64_t bytesCount, const bool succeed) noexcept
+    {
+        calls.fetch_add(1u, std::memory_order_relaxed);
+        bytes.fetch_add(bytesCount, std::memory_order_relaxed);
+        if(!succeed)
+        {
+            failures.fetch_add(1u, std::memory_order_relaxed);
+        }
+        latencies.record(latency);
+    }
+
+    void reset() noexcept
+    {
+        calls.store(0u, std::memory_order_relaxed);
+        bytes.store(0u, std::memory_order_relaxed);
+        failures.store(0u, std::memory_order_relaxed);
+        latencies.reset();
+    }
+
+    template<typename F>
+    static void forEach(F&& visit)
+    {
+        for(Site* site = head().load(std::memory_order_acquire); site; site = site->next)
+        {
+            visit(static_cast<const Site&>(*site));
+        }
+    }
+
+    const std::string_view name;
+    std::atomic<uint64_t> calls{};
+    std::atomic<uint64_t> bytes{};
+    std::atomic<uint64_t> failures{};
+    Histogram latencies;
+
+private:
+    static std::atomic<Site*>& head() noexcept
+    {
+        static std::atomic<Site*> first{nullptr};
+        return first;
+    }
+
+    Site* next = nullptr;
+
+}; // struct Site
+
+
+struct Event
+{
+    const Site*       site = nullptr;
+    Clock::time_point start{};
+    Nanoseconds       duration{};
+    uint64_t          bytes = 0u;
+    DWORD             threadId = 0u;
+};
+
+// Fixed size ring of the latest events, disabled until `enable` is called.
+// Writers claim a slot by its sequence, odd while the event is written, so two writers
+// a whole ring apart don't write one slot together, the later one drops its event.
+// Readers copy an event and keep it only if the sequence hasn't changed meanwhile.
+struct EventLog
+{
+    // False while the log is enabled, `disable` it first. Must not run together with forEach.
+    bool enable(const size_t capacity)
+    {
+        if(enabled())
+        {
+            return false;
+        }
+        while(0u != writers.load(std::memory_order_seq_cst))
+        {
+            std::this_thread::yield(); // records which saw the log still enabled
+        }
+        const size_t size = std::bit_ceil(capacity ? capacity : size_t{1});
+        slots = std::make_unique<Slot[]>(size);
+        mask = size - 1u;
+        written.store(0u, std::memory_order_relaxed);
+        active.store(true, std::memory_order_seq_cst);
+        return true;
+    }
+
+    void disable() noexcept
+    {
+        active.store(false, std::memory_order_seq_cst);
+    }
+
+    bool enabled() const noexcept
+    {
+        return active.load(std::memory_order_acquire);
+    }
+
+    void record(const Event& event) noexcept
+    {
+        if(!active.load(std::memory_order_relaxed))
+        {
+            return; // the common case, no writes to memory shared by all tracing threads
+        }
+        writers.fetch_add(1u, std::memory_order_seq_cst);
+        if(active.load(std::memory_order_seq_cst))
+        {
+            write(event);
+        }
+        writers.fetch_sub(1u, std::memory_order_release);
+    }
+
+    template<typename F>
+    void forEach(F&& visit) const
+    {
+        if(!slots)
+        {
+            return;
+        }
+        const uint64_t last = written.load(std::memory_order_acquire);
+        const uint64_t first = last > mask ? last - mask - 1u : 0u;
+        for(uint64_t ticket = first; ticket < last; ++ticket)
+        {
+            const Slot& slot = slots[ticket & mask];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if(sequence != writtenSequence(ticket))
+            {
+                continue;
+            }
+            const Event event = slot.event;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(slot.sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                visit(event); // not torn
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{};
+        Event event{};
+    };
+
+    static constexpr uint64_t writingSequence(const uint64_t ticket) noexcept
+    {
+        return 2u * ticket + 1u;
+    }
+
+    static constexpr uint64_t writtenSequence(const uint64_t ticket) noexcept
+    {
+        return 2u * ticket + 2u;
+    }
+
+    void write(const Event& event) noexcept
+    {
+        const uint64_t ticket = written.fetch_add(1u, std::memory_order_relaxed);
+        Slot& slot = slots[ticket & mask];
+        uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        do
+        {
+            if(0u != (sequence & 1u) || sequence >= writingSequence(ticket))
+            {
+                return; // being written, or already taken by a later event
+            }
+        }
+        while(!slot.sequence.compare_exchange_weak(sequence, writingSequence(ticket), std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.event = event;
+        slot.sequence.store(writtenSequence(ticket), std::memory_order_release);
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    uint64_t mask = 0u;
+    std::atomic<uint64_t> written{};
+    std::atomic<size_t> writers{0u};
+    std::atomic<bool> active{false};
+
+}; // struct EventLog
+
+inline EventLog& eventLog() noexcept
+{
+    static EventLog log;
+    return log;
+}
+
+// Writes the event log in the Chrome trace event format (chrome://tracing, Perfetto).
+static void exportChromeTrace(std::ostream& out, const EventLog& log = eventLog())
+{
+    const DWORD processId = ::GetCurrentProcessId();
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    log.forEach([&](const Event& event)
+    {
+        const auto start = std::chrono::duration<double, std::micro>(event.start.time_since_epoch());
+        const auto duration = std::chrono::duration<double, std::micro>(event.duration);
+        out << (first ? "" : ",")
+            << "{\"name\":\"" << (event.site ? event.site->name : std::string_view{"?"}) << '"'
+            << ",\"cat\":\"WinApi\",\"ph\":\"X\""
+            << ",\"ts\":" << start.count()
+            << ",\"dur\":" << duration.count()
+            << ",\"pid\":" << processId
+            << ",\"tid\":" << event.threadId
+            << ",\"args\":{\"bytes\":" << event.bytes << "}}";
+        first = false;
+    });
+    out << "]}";
+}
+
+
+template<bool Active>
+struct BasicScope
+{
+    constexpr BasicScope() noexcept = default;
+    constexpr explicit BasicScope(Site&) noexcept {}
+    constexpr void bytes(const uint64_t) noexcept {}
+    constexpr void failed() noexcept {}
+};
+
+template<>
+struct BasicScope<true>
+{
+    explicit BasicScope(Site& traced) noexcept
+        : site{traced}
+    {}
+
+    BasicScope(const BasicScope&) = delete;
+    BasicScope& operator = (const BasicScope&) = delete;
+
+    ~BasicScope()
+    {
+        const auto duration = std::chrono::duration_cast<Nanoseconds>(Clock::now() - start);
+        site.record(duration, transferred, succeed);
+        eventLog().record(Event
+        {
+              .site     = &site
+            , .start    = start
+            , .duration = duration
+            , .bytes    = transferred
+            , .threadId = ::GetCurrentThreadId()
+        });
+    }
+
+    void bytes(const uint64_t count) noexcept
+    {
+        transferred = count;
+    }
+
+    void failed() noexcept
+    {
+        succeed = false;
+    }
+
+private:
+    Site& site;
+    const Clock::time_point start = Clock::now();
+    uint64_t transferred = 0u;
+    bool succeed = true;
+
+}; // struct BasicScope<true>
+
+using Scope = BasicScope<Enabled>;
+
+} // namespace WinApi::Trace
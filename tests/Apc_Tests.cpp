@@ -0,0 +1,51 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/Apc.h>
+#include <WinApi/Sync/Event.h>
+#include <thread>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(Apc, RunsInAlertableWait)
+{
+    auto queue = ApcQueue::ofCurrentThread();
+    ASSERT_TRUE(queue.okay()) << queue.message();
+    const auto idle = Sync::createManualEvent().value();
+
+    std::vector<int> ran;
+    std::thread poster{[&]
+    {
+        for(int index = 0; index < 3; ++index)
+        {
+            EXPECT_TRUE(queue.value().post([&ran, index]{ ran.push_back(index); }).okay());
+        }
+    }};
+    poster.join();
+    EXPECT_TRUE(ran.empty()); // nothing runs until the thread waits alertably
+
+    const auto status = waitFor(idle, Milliseconds{1000}, Alertable);
+    ASSERT_TRUE(status.okay()) << status.message();
+    EXPECT_EQ(WaitStatus::IoCompletion, status.value());
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), ran);
+
+    const auto drained = waitFor(idle, Milliseconds{10}, Alertable);
+    ASSERT_TRUE(drained.okay()) << drained.message();
+    EXPECT_EQ(WaitStatus::Timeout, drained.value());
+}
+
+TEST(Apc, RunQueued)
+{
+    EXPECT_FALSE(runQueuedApcs());
+
+    auto queue = ApcQueue::ofCurrentThread();
+    ASSERT_TRUE(queue.okay()) << queue.message();
+    bool ran = false;
+    ASSERT_TRUE(queue.value().post([&ran]{ ran = true; }).okay());
+    EXPECT_TRUE(runQueuedApcs());
+    EXPECT_TRUE(ran);
+}
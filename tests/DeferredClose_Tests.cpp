@@ -0,0 +1,89 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/DeferredClose.h>
+#include <WinApi/IO/File.h>
+#include <WinApi/Sync/Event.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace WinApi;
+
+static IO::FileAccessReadWrite createTestFile(const std::string& name)
+{
+    return IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          name
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    ).value();
+}
+
+TEST(DeferredClose, ClosedAfterDrain)
+{
+    DeferredCloser closer;
+    for(int index = 0; index < 100; ++index)
+    {
+        auto file = createTestFile("test" + std::to_string(index));
+        closer.close(std::move(file));
+        EXPECT_FALSE(file);
+    }
+    closer.close(Sync::createManualEvent().value());
+    closer.drain();
+
+    for(int index = 0; index < 100; ++index)
+    {
+        EXPECT_FALSE(std::filesystem::exists("test" + std::to_string(index)));
+    }
+    EXPECT_EQ(101u, closer.stats().deferred + closer.stats().inlined);
+
+    uint64_t recorded = 0u;
+    for(size_t bucket = 0u; bucket < Trace::Histogram::Buckets; ++bucket)
+    {
+        recorded += closer.stats().deferredLatency.count(bucket);
+    }
+    EXPECT_EQ(closer.stats().deferred.load(), recorded);
+}
+
+// Holds the closer thread until the gate opens.
+static std::atomic<bool> closerBlocked{false};
+static HANDLE closerGate = nullptr;
+
+struct BlockingClose
+{
+    void operator () (const HANDLE handle) const
+    {
+        closerBlocked.store(true);
+        ::WaitForSingleObjectEx(closerGate, INFINITE, FALSE);
+        ::CloseHandle(handle);
+    }
+};
+
+TEST(DeferredClose, FullBacklogClosesInline)
+{
+    const auto gate = Sync::createManualEvent().value();
+    closerGate = gate.get();
+    DeferredCloser closer{DeferredCloseOptions{2u}};
+
+    closer.close(Handle<BlockingClose>{Sync::createManualEvent().value().release()});
+    while(!closerBlocked.load())
+    {
+        std::this_thread::yield();
+    }
+    closer.close(Sync::createAutoEvent().value());
+    closer.close(Sync::createAutoEvent().value());
+    EXPECT_EQ(3u, closer.stats().deferred.load());
+    EXPECT_EQ(0u, closer.stats().inlined.load());
+
+    closer.close(Sync::createAutoEvent().value());
+    EXPECT_EQ(1u, closer.stats().inlined.load());
+
+    Sync::setEvent(gate);
+    closer.drain();
+    EXPECT_EQ(3u, closer.stats().deferred.load());
+}
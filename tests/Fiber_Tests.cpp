@@ -0,0 +1,106 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/Fiber.h>
+#include <WinApi/Sync/Event.h>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(Fiber, YieldInterleaves)
+{
+    FiberScheduler scheduler;
+    std::vector<int> order;
+    for(int task = 0; task < 2; ++task)
+    {
+        scheduler.spawn([&order, task]
+        {
+            order.push_back(task);
+            yieldFiber();
+            order.push_back(task + 10);
+        });
+    }
+    ASSERT_TRUE(scheduler.run().okay());
+    // a ready fiber goes before a task which has not started yet
+    EXPECT_EQ((std::vector<int>{0, 10, 1, 11}), order);
+    EXPECT_EQ(1u, scheduler.liveFibers());
+    EXPECT_EQ(nullptr, FiberScheduler::current());
+}
+
+TEST(Fiber, WaitParksFiber)
+{
+    const auto event = Sync::createManualEvent().value();
+    FiberOptions options;
+    options.pooledFibers = 8u;
+    FiberScheduler scheduler{options};
+
+    constexpr size_t Waiters = 100u;
+    size_t woken = 0u;
+    for(size_t task = 0u; task < Waiters; ++task)
+    {
+        scheduler.spawn([&]
+        {
+            const auto status = fiberWaitFor(event);
+            EXPECT_EQ(WaitStatus::Object0, status.value());
+            ++woken;
+        });
+    }
+    scheduler.spawn([&]
+    {
+        EXPECT_EQ(0u, woken);
+        Sync::setEvent(event);
+    });
+    scheduler.spawn([&]
+    {
+        const auto status = fiberWaitFor(Sync::createManualEvent().value(), Milliseconds{10});
+        EXPECT_EQ(WaitStatus::Timeout, status.value());
+    });
+
+    ASSERT_TRUE(scheduler.run().okay());
+    EXPECT_EQ(Waiters, woken);
+    EXPECT_EQ(8u, scheduler.liveFibers()); // the others were deleted when they finished
+}
+
+TEST(Fiber, RethrowsFirstException)
+{
+    FiberScheduler scheduler;
+    bool finished = false;
+    scheduler.spawn([]{ throw std::runtime_error{"first"}; });
+    scheduler.spawn([&finished]{ finished = true; });
+    EXPECT_THROW(scheduler.run(), std::runtime_error);
+    EXPECT_TRUE(finished);
+}
+
+TEST(Fiber, YieldingDoesNotHoldOffWakes)
+{
+    const auto event = Sync::createManualEvent().value();
+    FiberScheduler scheduler;
+    bool woken = false;
+    scheduler.spawn([&]
+    {
+        EXPECT_EQ(WaitStatus::Object0, fiberWaitFor(event).value());
+        woken = true;
+    });
+    scheduler.spawn([&]
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        while(!woken && std::chrono::steady_clock::now() < deadline)
+        {
+            yieldFiber();
+        }
+        EXPECT_TRUE(woken);
+    });
+
+    std::jthread setter{[&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        Sync::setEvent(event);
+    }};
+    ASSERT_TRUE(scheduler.run().okay());
+}
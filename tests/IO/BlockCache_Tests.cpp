@@ -0,0 +1,197 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/BlockCache.h>
+#include <thread>
+#include <vector>
+
+using namespace WinApi;
+
+static auto createTestFile(const size_t size)
+{
+    auto file = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::Read
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    ).value();
+    std::vector<std::byte> data(size);
+    for(size_t index = 0u; index < size; ++index)
+    {
+        data[index] = static_cast<std::byte>(index * 7u);
+    }
+    IO::fileWrite(file, data.data(), data.data() + data.size());
+    return file;
+}
+
+static IO::BlockCacheOptions testOptions(const size_t blocks, const size_t shards)
+{
+    IO::BlockCacheOptions options;
+    options.blockSize = IO::CountOfBytes{} + IO::OneByte * 512u;
+    options.blocks = blocks;
+    options.shards = shards;
+    return options;
+}
+
+TEST(IO_BlockCache, ReadAcrossBlocks)
+{
+    const auto file = createTestFile(2000u);
+    IO::BlockCache cache{file, testOptions(8u, 2u)};
+
+    std::vector<std::byte> buffer(1000u);
+    auto read = cache.read(IO::CountOfBytes{} + IO::OneByte * 300u, buffer);
+    ASSERT_TRUE(read.okay()) << read.message();
+    ASSERT_EQ(1000u, static_cast<size_t>(read.value()));
+    for(size_t index = 0u; index < buffer.size(); ++index)
+    {
+        ASSERT_EQ(static_cast<std::byte>((index + 300u) * 7u), buffer[index]);
+    }
+    EXPECT_EQ(3u, cache.stats().misses);
+
+    // the last block is short
+    auto tail = cache.read(IO::CountOfBytes{} + IO::OneByte * 1900u, buffer);
+    ASSERT_TRUE(tail.okay()) << tail.message();
+    EXPECT_EQ(100u, static_cast<size_t>(tail.value()));
+    EXPECT_EQ(4u, cache.stats().misses);
+}
+
+TEST(IO_BlockCache, ClockSkipsPinnedAndReferenced)
+{
+    const auto file = createTestFile(8u * 512u);
+    IO::BlockCache cache{file, testOptions(2u, 1u)};
+
+    auto pinned = cache.pin(0u);
+    ASSERT_TRUE(pinned.okay()) << pinned.message();
+    ASSERT_TRUE(cache.pin(1u).okay());
+    ASSERT_TRUE(cache.pin(2u).okay());
+    EXPECT_EQ(1u, cache.stats().evictions);
+
+    // block 0 is still cached since it is pinned
+    ASSERT_TRUE(cache.pin(0u).okay());
+    EXPECT_EQ(1u, cache.stats().hits);
+    EXPECT_EQ(static_cast<std::byte>(7u), pinned.value().data()[1]);
+
+    auto second = cache.pin(3u);
+    ASSERT_TRUE(second.okay()) << second.message();
+    auto busy = cache.pin(4u);
+    ASSERT_FALSE(busy.okay());
+    EXPECT_EQ(ERROR_BUSY, static_cast<DWORD>(busy.code().code().value()));
+
+    pinned.value().release();
+    ASSERT_TRUE(cache.pin(4u).okay());
+}
+
+TEST(IO_BlockCache, ConcurrentMissesReadOnce)
+{
+    const auto file = createTestFile(4u * 512u);
+    IO::BlockCache cache{file, testOptions(4u, 1u)};
+
+    std::vector<std::thread> readers;
+    for(size_t index = 0u; index < 8u; ++index)
+    {
+        readers.emplace_back([&cache]
+        {
+            auto block = cache.pin(1u);
+            EXPECT_TRUE(block.okay());
+            EXPECT_EQ(512u, block.value().data().size());
+        });
+    }
+    for(auto& reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_EQ(1u, cache.stats().misses);
+    EXPECT_EQ(7u, cache.stats().hits);
+}
+
+TEST(IO_BlockCache, Prefetch)
+{
+    const auto file = createTestFile(3u * 512u + 10u);
+    auto options = testOptions(8u, 4u);
+    options.prefetch = 8u;
+    IO::BlockCache cache{file, options};
+
+    ASSERT_TRUE(cache.pin(0u).okay());
+    cache.drain();
+    EXPECT_EQ(3u, cache.stats().prefetched);
+    ASSERT_TRUE(cache.pin(3u).okay());
+    EXPECT_EQ(10u, cache.pin(3u).value().data().size());
+    EXPECT_EQ(1u, cache.stats().misses);
+    EXPECT_EQ(2u, cache.stats().hits);
+}
+
+TEST(IO_BlockCache, NothingCachedPastEnd)
+{
+    const auto file = createTestFile(4u * 512u);
+    auto options = testOptions(16u, 4u);
+    options.prefetch = 8u;
+    IO::BlockCache cache{file, options};
+
+    ASSERT_TRUE(cache.pin(0u).okay());
+    cache.drain();
+    EXPECT_EQ(3u, cache.stats().prefetched);
+
+    // the prefetch has seen the end, so these don't read
+    auto past = cache.pin(4u);
+    ASSERT_TRUE(past.okay()) << past.message();
+    EXPECT_TRUE(past.value().data().empty());
+    ASSERT_TRUE(cache.pin(5u).okay());
+    EXPECT_EQ(1u, cache.stats().misses);
+
+    std::vector<std::byte> buffer(100u);
+    auto read = cache.read(IO::CountOfBytes{} + IO::OneByte * (4u * 512u), buffer);
+    ASSERT_TRUE(read.okay()) << read.message();
+    EXPECT_EQ(0u, static_cast<size_t>(read.value()));
+}
+
+TEST(IO_BlockCache, PastEndReadOnce)
+{
+    const auto file = createTestFile(2u * 512u);
+    IO::BlockCache cache{file, testOptions(8u, 2u)};
+
+    EXPECT_TRUE(cache.pin(2u).value().data().empty());
+    EXPECT_TRUE(cache.pin(2u).value().data().empty());
+    EXPECT_TRUE(cache.pin(7u).value().data().empty());
+    EXPECT_EQ(1u, cache.stats().misses);
+}
+
+TEST(IO_BlockCache, OverlappedFile)
+{
+    const auto written = createTestFile(16u * 512u);
+    const auto file = IO::createFile<IO::DesiredAccess::GenericRead>
+    (
+          "test"
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::OpenExisting
+        , IO::FileFlag::Overllaped
+    ).value();
+    auto options = testOptions(16u, 4u);
+    options.prefetch = 2u;
+    IO::BlockCache cache{file, options};
+
+    std::vector<std::thread> readers;
+    for(size_t reader = 0u; reader < 4u; ++reader)
+    {
+        readers.emplace_back([&cache, reader]
+        {
+            std::vector<std::byte> buffer(4u * 512u);
+            const size_t offset = reader * buffer.size();
+            auto read = cache.read(IO::CountOfBytes{} + IO::OneByte * offset, buffer);
+            ASSERT_TRUE(read.okay()) << read.message();
+            ASSERT_EQ(buffer.size(), static_cast<size_t>(read.value()));
+            for(size_t index = 0u; index < buffer.size(); ++index)
+            {
+                ASSERT_EQ(static_cast<std::byte>((offset + index) * 7u), buffer[index]);
+            }
+        });
+    }
+    for(auto& reader : readers)
+    {
+        reader.join();
+    }
+    cache.drain();
+}
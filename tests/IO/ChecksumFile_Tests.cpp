@@ -0,0 +1,68 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/ChecksumFile.h>
+#include <string>
+
+using namespace WinApi;
+
+TEST(IO_ChecksumFile, WriteThenVerify)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    const std::string first(5000, 'a');
+    const std::string second = "123456789";
+    IO::Crc32c writeHasher;
+    IO::fileWriteDataChecked(file, first, writeHasher);
+    const auto written = IO::fileWriteDataChecked(file, second, writeHasher);
+    EXPECT_EQ(Utils::countOf(second), written.count);
+
+    ASSERT_TRUE(IO::setFilePointerToBegin(file).okay());
+    std::string actual(first.size() + second.size() + 10u, '\0');
+    IO::Crc32c readHasher;
+    const auto read = IO::fileReadDataChecked(file, actual, readHasher);
+    EXPECT_EQ(Utils::countOf(first + second), read.count);
+    EXPECT_EQ(written.digest, read.digest);
+
+    const std::string whole = first + second;
+    IO::Crc32c expected;
+    expected.update(std::as_bytes(std::span{whole.data(), whole.size()}));
+    EXPECT_EQ(expected.digest(), read.digest);
+}
+
+TEST(IO_ChecksumFile, PartialTrailingElementHashed)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    const std::string data = "123456789";
+    ASSERT_EQ(Utils::countOf(data), IO::fileWriteData(file, data));
+    ASSERT_TRUE(IO::setFilePointerToBegin(file).okay());
+
+    uint32_t buffer[4]{};
+    IO::Crc32c hasher;
+    const auto read = IO::fileReadChecked(file, std::begin(buffer), std::end(buffer), hasher);
+    EXPECT_EQ(2u, static_cast<size_t>(read.count));
+
+    IO::Crc32c expected;
+    expected.update(std::as_bytes(std::span{data.data(), data.size()}));
+    EXPECT_EQ(expected.digest(), read.digest);
+}
@@ -0,0 +1,162 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/DirectoryWatcher.h>
+#include <fstream>
+
+using namespace WinApi;
+
+namespace
+{
+
+struct TestDirectory
+{
+    TestDirectory()
+    {
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+    }
+
+    ~TestDirectory()
+    {
+        std::filesystem::remove_all(root);
+    }
+
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "CppWinApi_DirectoryWatcher_Tests";
+};
+
+// Collects batches until `expected` changes arrived or nothing comes for a while.
+std::vector<IO::DirectoryChange> collect(IO::DirectoryWatcher& watcher, const size_t expected)
+{
+    std::vector<IO::DirectoryChange> changes;
+    while(changes.size() < expected)
+    {
+        auto batch = watcher.waitChanges(Milliseconds{2000});
+        if(!batch.okay() || batch.value().changes.empty())
+        {
+            break;
+        }
+        for(auto& change : batch.value().changes)
+        {
+            changes.push_back(std::move(change));
+        }
+    }
+    return changes;
+}
+
+} // namespace
+
+TEST(IO_DirectoryWatcher, CreateModifyRenameDelete)
+{
+    const TestDirectory directory;
+    auto watcher = IO::DirectoryWatcher::create(directory.root);
+    ASSERT_TRUE(watcher.okay()) << watcher.message();
+
+    auto nothing = watcher.value().readChanges();
+    ASSERT_TRUE(nothing.okay()) << nothing.message();
+    EXPECT_TRUE(nothing.value().changes.empty());
+    EXPECT_FALSE(nothing.value().overflow);
+
+    std::ofstream{directory.root / "segment"} << "data";
+    const auto created = collect(watcher.value(), 1u);
+    ASSERT_FALSE(created.empty());
+    EXPECT_EQ(IO::ChangeAction::Created, created.front().action);
+    EXPECT_EQ(directory.root / "segment", created.front().path);
+
+    std::filesystem::rename(directory.root / "segment", directory.root / "renamed");
+    const auto renamed = collect(watcher.value(), 1u);
+    ASSERT_EQ(1u, renamed.size());
+    EXPECT_EQ(IO::ChangeAction::Renamed, renamed.front().action);
+    EXPECT_EQ(directory.root / "segment", renamed.front().oldPath);
+    EXPECT_EQ(directory.root / "renamed", renamed.front().path);
+
+    std::filesystem::remove(directory.root / "renamed");
+    const auto deleted = collect(watcher.value(), 1u);
+    ASSERT_EQ(1u, deleted.size());
+    EXPECT_EQ(IO::ChangeAction::Deleted, deleted.front().action);
+}
+
+TEST(IO_DirectoryWatcher, MovedOutIsDeleted)
+{
+    const TestDirectory directory;
+    const std::filesystem::path watched = directory.root / "watched";
+    std::filesystem::create_directories(watched);
+    std::ofstream{watched / "segment"} << "data";
+
+    auto watcher = IO::DirectoryWatcher::create(watched);
+    ASSERT_TRUE(watcher.okay()) << watcher.message();
+
+    std::filesystem::rename(watched / "segment", directory.root / "segment");
+    const auto moved = collect(watcher.value(), 1u);
+    ASSERT_EQ(1u, moved.size());
+    EXPECT_EQ(IO::ChangeAction::Deleted, moved.front().action);
+    EXPECT_EQ(watched / "segment", moved.front().path);
+}
+
+TEST(IO_DirectoryWatcher, Overflow)
+{
+    const TestDirectory directory;
+    auto watcher = IO::DirectoryWatcher::create(directory.root, false, IO::ChangeFlag::FileName, 64u);
+    ASSERT_TRUE(watcher.okay()) << watcher.message();
+
+    for(int index = 0; index < 100; ++index)
+    {
+        std::ofstream{directory.root / ("segment" + std::to_string(index))};
+    }
+    // the first batches may have been taken before the burst filled the buffer
+    bool overflow = false;
+    for(int batches = 0; !overflow && batches < 100; ++batches)
+    {
+        auto batch = watcher.value().waitChanges(Milliseconds{2000});
+        ASSERT_TRUE(batch.okay()) << batch.message();
+        overflow = batch.value().overflow;
+        if(!overflow && batch.value().changes.empty())
+        {
+            break;
+        }
+    }
+    EXPECT_TRUE(overflow);
+}
+
+TEST(IO_DirectoryWatcher, InvalidatesInfoCache)
+{
+    const TestDirectory directory;
+    std::ofstream{directory.root / "segment"} << "data";
+    auto watcher = IO::DirectoryWatcher::create(directory.root);
+    ASSERT_TRUE(watcher.okay()) << watcher.message();
+
+    IO::FileInfoCache cache;
+    EXPECT_EQ(4u, static_cast<size_t>(cache.get(directory.root / "segment").value().size));
+
+    std::ofstream{directory.root / "segment", std::ios::app} << "more";
+    auto batch = watcher.value().waitChanges(Milliseconds{2000});
+    ASSERT_TRUE(batch.okay()) << batch.message();
+    IO::invalidateChanged(cache, batch.value());
+    EXPECT_EQ(8u, static_cast<size_t>(cache.get(directory.root / "segment").value().size));
+
+    IO::invalidateChanged(cache, IO::ChangeBatch{{}, true});
+    EXPECT_EQ(0u, cache.size());
+}
+
+TEST(IO_DirectoryWatcher, InvalidatesOtherSpelling)
+{
+    const TestDirectory directory;
+    std::ofstream{directory.root / "segment"} << "data";
+    auto watcher = IO::DirectoryWatcher::create(directory.root);
+    ASSERT_TRUE(watcher.okay()) << watcher.message();
+
+    // forward slashes, a dot and another case than the watcher reports
+    const std::filesystem::path spelled{directory.root.generic_string() + "/./SEGMENT"};
+    IO::FileInfoCache cache;
+    EXPECT_EQ(4u, static_cast<size_t>(cache.get(spelled).value().size));
+
+    std::ofstream{directory.root / "segment", std::ios::app} << "more";
+    auto batch = watcher.value().waitChanges(Milliseconds{2000});
+    ASSERT_TRUE(batch.okay()) << batch.message();
+    IO::invalidateChanged(cache, batch.value());
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(8u, static_cast<size_t>(cache.get(spelled).value().size));
+}
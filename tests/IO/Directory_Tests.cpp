@@ -0,0 +1,151 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/Directory.h>
+#include <atomic>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace WinApi;
+
+namespace
+{
+
+struct TestTree
+{
+    // root/{file0..file4, dir0..dir2/{file0..file4, dir0..dir2/{file0..file4}}}
+    TestTree()
+    {
+        std::filesystem::remove_all(root);
+        populate(root, 2);
+    }
+
+    ~TestTree()
+    {
+        std::filesystem::remove_all(root);
+    }
+
+    static void populate(const std::filesystem::path& directory, const int depth)
+    {
+        std::filesystem::create_directories(directory);
+        for(int index = 0; index < 5; ++index)
+        {
+            std::ofstream{directory / ("file" + std::to_string(index))} << std::string(index, 'x');
+        }
+        for(int index = 0; depth > 0 && index < 3; ++index)
+        {
+            populate(directory / ("dir" + std::to_string(index)), depth - 1);
+        }
+    }
+
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "CppWinApi_Directory_Tests";
+};
+
+} // namespace
+
+TEST(IO_Directory, ReadInBatches)
+{
+    const TestTree tree;
+    auto maybeDirectory = IO::openDirectory(tree.root);
+    ASSERT_TRUE(maybeDirectory.okay()) << maybeDirectory.message();
+    auto directory = std::move(maybeDirectory).value();
+
+    std::set<std::wstring> names;
+    std::vector<IO::DirectoryEntry> batch;
+    for(;;)
+    {
+        const auto read = IO::directoryRead(directory, batch, 3u);
+        ASSERT_TRUE(read.okay()) << read.message();
+        ASSERT_LE(batch.size(), 3u);
+        if(batch.empty())
+        {
+            break;
+        }
+        for(const auto& entry : batch)
+        {
+            EXPECT_EQ(entry.name.starts_with(L"dir"), entry.isDirectory());
+            if(!entry.isDirectory())
+            {
+                EXPECT_EQ(Utils::CountOfBytes{} + Utils::OneByte * (entry.name.back() - L'0'), entry.size);
+            }
+            names.insert(entry.name);
+        }
+    }
+    EXPECT_EQ(8u, names.size());
+}
+
+TEST(IO_Directory, OpenMissing)
+{
+    const auto directory = IO::openDirectory(std::filesystem::temp_directory_path() / "CppWinApi_Missing");
+    EXPECT_FALSE(directory.okay());
+}
+
+TEST(IO_Directory, ParallelWalk)
+{
+    const TestTree tree;
+    std::atomic<size_t> files{};
+    std::atomic<size_t> directories{};
+    std::atomic<size_t> bytes{};
+    const auto walked = IO::walkDirectory(tree.root, [&](const std::filesystem::path&, std::span<const IO::DirectoryEntry> batch)
+    {
+        for(const auto& entry : batch)
+        {
+            if(entry.isDirectory())
+            {
+                ++directories;
+            }
+            else
+            {
+                ++files;
+                bytes += static_cast<size_t>(entry.size);
+            }
+        }
+    }, 4u, 2u);
+    ASSERT_TRUE(walked.okay()) << walked.message();
+    EXPECT_EQ(3u + 9u, directories.load());
+    EXPECT_EQ(5u * 13u, files.load());
+    EXPECT_EQ(10u * 13u, bytes.load());
+}
+
+TEST(IO_Directory, WalkStopsOnException)
+{
+    const TestTree tree;
+    for(const size_t workers : {1u, 4u})
+    {
+        std::atomic<size_t> visits{};
+        EXPECT_THROW(IO::walkDirectory(tree.root, [&](const std::filesystem::path& directory, std::span<const IO::DirectoryEntry>)
+        {
+            ++visits;
+            if(directory.filename() == "dir1")
+            {
+                throw std::runtime_error{"visit failed"};
+            }
+        }, workers, 2u), std::runtime_error);
+        EXPECT_LT(0u, visits.load());
+    }
+}
+
+TEST(IO_Directory, WalkReportsErrors)
+{
+    const TestTree tree;
+    std::vector<std::filesystem::path> failed;
+    const auto walked = IO::walkDirectory(tree.root, [&](const std::filesystem::path& directory, std::span<const IO::DirectoryEntry>)
+    {
+        if(directory == tree.root)
+        {
+            std::filesystem::remove_all(tree.root / "dir0"); // queued, but gone before it is opened
+        }
+    }, 1u, 4096u, {}, [&](const std::filesystem::path& directory, const OccurredError error)
+    {
+        EXPECT_NE(0, error.code().value());
+        failed.push_back(directory);
+    });
+    ASSERT_TRUE(walked.okay()) << walked.message();
+    ASSERT_EQ(1u, failed.size());
+    EXPECT_EQ(tree.root / "dir0", failed.front());
+}
@@ -0,0 +1,60 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FiberFile.h>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(IO_FiberFile, ManyFibersOneThread)
+{
+    const auto file = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose | IO::FileFlag::Overllaped
+    ).value();
+
+    constexpr size_t Tasks = 200u;
+    constexpr size_t BlockSize = 256u;
+    size_t verified = 0u;
+    FiberScheduler scheduler;
+    for(size_t task = 0u; task < Tasks; ++task)
+    {
+        scheduler.spawn([&, task]
+        {
+            const auto offset = IO::CountOfBytes{} + IO::OneByte * (task * BlockSize);
+            const std::vector<std::byte> block(BlockSize, static_cast<std::byte>(task));
+            const auto written = IO::fiberWriteAt(file, offset, block);
+            ASSERT_TRUE(written.okay()) << written.message();
+            EXPECT_EQ(BlockSize, static_cast<size_t>(written.value()));
+
+            std::vector<std::byte> back(BlockSize);
+            const auto read = IO::fiberReadAt(file, offset, back);
+            ASSERT_TRUE(read.okay()) << read.message();
+            EXPECT_EQ(block, back);
+            ++verified;
+        });
+    }
+    ASSERT_TRUE(scheduler.run().okay());
+    EXPECT_EQ(Tasks, verified);
+}
+
+TEST(IO_FiberFile, OutsideOfFiber)
+{
+    const auto file = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose | IO::FileFlag::Overllaped
+    ).value();
+    const std::vector<std::byte> data(100u, std::byte{5});
+    const auto written = IO::fiberWriteAt(file, IO::CountOfBytes{}, data);
+    ASSERT_TRUE(written.okay()) << written.message();
+    EXPECT_EQ(100u, static_cast<size_t>(written.value()));
+}
@@ -0,0 +1,79 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FileAllocation.h>
+#include <cstring>
+#include <vector>
+
+using namespace WinApi;
+
+namespace
+{
+
+constexpr auto KiB = Utils::OneByte * 1024;
+
+IO::FileAccessReadWrite createTemporary()
+{
+    return IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    ).value();
+}
+
+} // namespace
+
+TEST(IO_FileAllocation, SizeAndPreallocation)
+{
+    const auto file = createTemporary();
+
+    ASSERT_TRUE(IO::preallocateFile(file, Utils::CountOfBytes{} + KiB * 1024).okay()) << lastErrorMessage();
+    EXPECT_EQ(Utils::CountOfBytes{}, IO::getFileSize(file).value());
+
+    ASSERT_TRUE(IO::setFileSize(file, Utils::CountOfBytes{} + KiB * 64).okay()) << lastErrorMessage();
+    EXPECT_EQ(Utils::CountOfBytes{} + KiB * 64, IO::getFileSize(file).value());
+
+    ASSERT_TRUE(IO::setFileSize(file, Utils::CountOfBytes{} + KiB).okay()) << lastErrorMessage();
+    EXPECT_EQ(Utils::CountOfBytes{} + KiB, IO::getFileSize(file).value());
+}
+
+TEST(IO_FileAllocation, PreallocationKeepsData)
+{
+    const auto file = createTemporary();
+    ASSERT_TRUE(IO::setFileSize(file, Utils::CountOfBytes{} + KiB * 64).okay()) << lastErrorMessage();
+
+    ASSERT_TRUE(IO::preallocateFile(file, Utils::CountOfBytes{} + KiB).okay()) << lastErrorMessage();
+    EXPECT_EQ(Utils::CountOfBytes{} + KiB * 64, IO::getFileSize(file).value());
+}
+
+TEST(IO_FileAllocation, PunchHole)
+{
+    const auto file = createTemporary();
+    ASSERT_TRUE(IO::setFileSparse(file).okay()) << lastErrorMessage();
+
+    const std::vector<char> data(1024 * 1024, 'x');
+    ASSERT_EQ(Utils::countOf(data), IO::fileWriteData(file, data));
+
+    const IO::FileRange hole{Utils::CountOfBytes{} + KiB * 256, Utils::CountOfBytes{} + KiB * 512};
+    ASSERT_TRUE(IO::punchFileHole(file, hole).okay()) << lastErrorMessage();
+
+    const auto ranges = IO::getFileAllocatedRanges(file);
+    ASSERT_TRUE(ranges.okay()) << ranges.message();
+    ASSERT_FALSE(ranges.value().empty());
+    for(const IO::FileRange& range : ranges.value())
+    {
+        EXPECT_TRUE(range.end() <= hole.begin || hole.end() <= range.begin);
+    }
+    EXPECT_EQ(Utils::CountOfBytes{}, ranges.value().front().begin);
+    EXPECT_EQ(Utils::CountOfBytes{} + KiB * 1024, ranges.value().back().end());
+
+    char zeroes[16]{};
+    char read[16]{'?'};
+    ASSERT_TRUE(IO::fileReadAt(file, hole.begin, std::begin(read), std::end(read)).okay());
+    EXPECT_EQ(0, std::memcmp(zeroes, read, sizeof(read)));
+}
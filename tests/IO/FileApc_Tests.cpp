@@ -0,0 +1,76 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FileApc.h>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(IO_FileApc, ManyRequestsOnOneThread)
+{
+    const auto file = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose | IO::FileFlag::Overllaped
+    ).value();
+
+    constexpr size_t Blocks = 64u;
+    constexpr size_t BlockSize = 512u;
+    std::vector<std::byte> written(Blocks * BlockSize);
+    for(size_t index = 0u; index < written.size(); ++index)
+    {
+        written[index] = static_cast<std::byte>(index / BlockSize);
+    }
+
+    size_t completed = 0u;
+    for(size_t block = 0u; block < Blocks; ++block)
+    {
+        const auto issued = IO::fileWriteAsync
+        (
+              file
+            , IO::CountOfBytes{} + IO::OneByte * (block * BlockSize)
+            , std::span<const std::byte>{written}.subspan(block * BlockSize, BlockSize)
+            , [&](Maybe<IO::CountOfBytes> transferred)
+              {
+                  EXPECT_EQ(BlockSize, static_cast<size_t>(transferred.value()));
+                  ++completed;
+              }
+        );
+        ASSERT_TRUE(issued.okay()) << issued.message();
+    }
+    while(completed < Blocks)
+    {
+        ::SleepEx(INFINITE, TRUE);
+    }
+
+    std::vector<std::byte> read(written.size());
+    completed = 0u;
+    size_t total = 0u;
+    for(size_t block = 0u; block < Blocks; ++block)
+    {
+        const auto issued = IO::fileReadAsync
+        (
+              file
+            , IO::CountOfBytes{} + IO::OneByte * (block * BlockSize)
+            , std::span<std::byte>{read}.subspan(block * BlockSize, BlockSize)
+            , [&](Maybe<IO::CountOfBytes> transferred)
+              {
+                  ASSERT_TRUE(transferred.okay()) << transferred.message();
+                  total += static_cast<size_t>(transferred.value());
+                  ++completed;
+              }
+        );
+        ASSERT_TRUE(issued.okay()) << issued.message();
+    }
+    while(completed < Blocks)
+    {
+        ::SleepEx(INFINITE, TRUE);
+    }
+    EXPECT_EQ(written.size(), total);
+    EXPECT_EQ(written, read);
+}
@@ -0,0 +1,171 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FileCopy.h>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace WinApi;
+
+namespace
+{
+
+IO::FileAccessReadWrite createTemporary(const char* const name)
+{
+    return IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          name
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    ).value();
+}
+
+std::vector<uint32_t> writeSequence(const IO::FileAccessReadWrite& file, const size_t count)
+{
+    std::vector<uint32_t> data(count);
+    std::iota(data.begin(), data.end(), 0u);
+    IO::fileWriteData(file, data);
+    return data;
+}
+
+} // namespace
+
+TEST(IO_FileCopy, WholeFile)
+{
+    const auto source = createTemporary("copy_source");
+    const auto destination = createTemporary("copy_destination");
+    const auto expected = writeSequence(source, 100000u);
+
+    IO::CopyOptions options;
+    options.bufferSize = Utils::CountOfBytes{} + Utils::OneByte * 4097; // not a multiple of the element
+    options.buffers = 3u;
+    Utils::CountOfBytes reported{};
+    options.progress = [&](const Utils::CountOfBytes copied, const Utils::CountOfBytes total)
+    {
+        EXPECT_LT(reported, copied);
+        EXPECT_LE(copied, total);
+        reported = copied;
+    };
+
+    const auto copied = IO::fileCopy(source, destination, options);
+    ASSERT_TRUE(copied.okay()) << copied.message();
+    EXPECT_EQ(Utils::sizeOf(Utils::countOf(expected)), copied.value());
+    EXPECT_EQ(copied.value(), reported);
+
+    std::vector<uint32_t> actual(expected.size());
+    ASSERT_TRUE(IO::setFilePointerToBegin(destination).okay());
+    IO::fileReadData(destination, actual);
+    EXPECT_EQ(expected, actual);
+}
+
+TEST(IO_FileCopy, Range)
+{
+    const auto source = createTemporary("copy_source");
+    const auto destination = createTemporary("copy_destination");
+    const auto expected = writeSequence(source, 1024u);
+
+    const IO::FileRange range
+    {
+          .begin = Utils::CountOfBytes{} + Utils::OneByte * (24 * sizeof(uint32_t))
+        , .size  = Utils::CountOfBytes{} + Utils::OneByte * (10 * sizeof(uint32_t))
+    };
+    const auto copied = IO::fileCopy(source, destination, range);
+    ASSERT_TRUE(copied.okay()) << copied.message();
+    EXPECT_EQ(range.size, copied.value());
+
+    uint32_t actual[10]{};
+    const auto read = IO::fileReadAt(destination, range.begin, std::begin(actual), std::end(actual));
+    ASSERT_TRUE(read.okay()) << read.message();
+    EXPECT_EQ(Utils::countOf(actual), read.value());
+    EXPECT_EQ(24u, actual[0]);
+    EXPECT_EQ(33u, actual[9]);
+}
+
+TEST(IO_FileCopy, Cancel)
+{
+    const auto source = createTemporary("copy_source");
+    const auto destination = createTemporary("copy_destination");
+    writeSequence(source, 100000u);
+
+    std::stop_source stop;
+    IO::CopyOptions options;
+    options.bufferSize = Utils::CountOfBytes{} + Utils::OneByte * 4096;
+    options.stop = stop.get_token();
+    options.progress = [&](Utils::CountOfBytes, Utils::CountOfBytes)
+    {
+        stop.request_stop();
+    };
+
+    const auto copied = IO::fileCopy(source, destination, options);
+    ASSERT_FALSE(copied.okay());
+    EXPECT_EQ(ERROR_OPERATION_ABORTED, copied.code().code().value());
+}
+
+TEST(IO_FileCopy, StopAfterLastChunk)
+{
+    const auto source = createTemporary("copy_source");
+    const auto destination = createTemporary("copy_destination");
+    writeSequence(source, 1000u);
+
+    std::stop_source stop;
+    IO::CopyOptions options;
+    options.stop = stop.get_token();
+    options.progress = [&](Utils::CountOfBytes, Utils::CountOfBytes)
+    {
+        stop.request_stop();
+    };
+
+    const auto copied = IO::fileCopy(source, destination, options);
+    ASSERT_TRUE(copied.okay()) << copied.message();
+    EXPECT_EQ(Utils::CountOfBytes{} + Utils::OneByte * (1000u * sizeof(uint32_t)), copied.value());
+}
+
+TEST(IO_FileCopy, ProgressThrows)
+{
+    const auto source = createTemporary("copy_source");
+    const auto destination = createTemporary("copy_destination");
+    writeSequence(source, 100000u);
+
+    IO::CopyOptions options;
+    options.bufferSize = Utils::CountOfBytes{} + Utils::OneByte * 4096;
+    options.buffers = 2u;
+    options.progress = [](Utils::CountOfBytes, Utils::CountOfBytes)
+    {
+        throw std::runtime_error{"progress"};
+    };
+
+    EXPECT_THROW(IO::fileCopy(source, destination, options), std::runtime_error);
+}
+
+TEST(IO_FileCopy, RangeKeepsDestinationTail)
+{
+    const auto source = createTemporary("copy_source");
+    const auto destination = createTemporary("copy_destination");
+    writeSequence(source, 1024u);
+    const auto expected = writeSequence(destination, 4096u);
+
+    const IO::FileRange range{Utils::CountOfBytes{}, Utils::CountOfBytes{} + Utils::OneByte * (16 * sizeof(uint32_t))};
+    ASSERT_TRUE(IO::fileCopy(source, destination, range).okay());
+    EXPECT_EQ(Utils::sizeOf(Utils::countOf(expected)), IO::getFileSize(destination).value());
+}
+
+TEST(IO_FileCopy, CopyFileProgressThrows)
+{
+    std::ofstream{"copy_source"} << std::string(100000u, 'x');
+
+    IO::CopyOptions options;
+    options.progress = [](Utils::CountOfBytes, Utils::CountOfBytes)
+    {
+        throw std::runtime_error{"progress"};
+    };
+
+    EXPECT_THROW(IO::copyFile("copy_source", "copy_destination", options), std::runtime_error);
+    EXPECT_FALSE(std::filesystem::exists("copy_destination"));
+    std::filesystem::remove("copy_source");
+}
@@ -0,0 +1,181 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FileHandleCache.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WinApi;
+
+static std::vector<IO::File<IO::DesiredAccess::GenericReadWrite>> createTestFiles(const size_t count)
+{
+    std::vector<IO::File<IO::DesiredAccess::GenericReadWrite>> files;
+    for(size_t index = 0u; index < count; ++index)
+    {
+        files.push_back(IO::createFile<IO::DesiredAccess::GenericReadWrite>
+        (
+              "test" + std::to_string(index)
+            , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+            , IO::CreateMode::CreateAlways
+            , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+        ).value());
+    }
+    return files;
+}
+
+TEST(IO_FileHandleCache, HitsAndEvictions)
+{
+    const auto files = createTestFiles(3u);
+    IO::FileHandleCache cache{IO::FileHandleCacheOptions{2u}};
+
+    auto first = cache.open<IO::DesiredAccess::GenericRead>("test0");
+    ASSERT_TRUE(first.okay()) << first.message();
+    auto again = cache.open<IO::DesiredAccess::GenericRead>("test0");
+    ASSERT_TRUE(again.okay()) << again.message();
+    EXPECT_EQ(first.value(), again.value());
+
+    auto writable = cache.open<IO::DesiredAccess::GenericWrite>("test0");
+    ASSERT_TRUE(writable.okay()) << writable.message();
+    EXPECT_EQ(2u, cache.openHandles());
+
+    // both handles are in use, so the cache grows over its capacity
+    auto second = cache.open<IO::DesiredAccess::GenericRead>("test1");
+    ASSERT_TRUE(second.okay()) << second.message();
+    EXPECT_EQ(3u, cache.openHandles());
+    EXPECT_EQ(0u, cache.stats().evictions);
+
+    first.value().reset();
+    again.value().reset();
+    auto third = cache.open<IO::DesiredAccess::GenericRead>("test2");
+    ASSERT_TRUE(third.okay()) << third.message();
+    EXPECT_EQ(3u, cache.openHandles());
+    EXPECT_EQ(1u, cache.stats().evictions);
+
+    EXPECT_EQ(1u, cache.stats().hits);
+    EXPECT_EQ(4u, cache.stats().misses);
+    EXPECT_DOUBLE_EQ(0.2, cache.stats().hitRate());
+}
+
+TEST(IO_FileHandleCache, MaxOpen)
+{
+    const auto files = createTestFiles(2u);
+    IO::FileHandleCacheOptions options;
+    options.maxOpen = 1u;
+    IO::FileHandleCache cache{options};
+
+    auto first = cache.open<IO::DesiredAccess::GenericRead>("test0");
+    ASSERT_TRUE(first.okay()) << first.message();
+    auto refused = cache.open<IO::DesiredAccess::GenericRead>("test1");
+    ASSERT_FALSE(refused.okay());
+    EXPECT_EQ(ERROR_TOO_MANY_OPEN_FILES, static_cast<DWORD>(refused.code().code().value()));
+}
+
+TEST(IO_FileHandleCache, Missing)
+{
+    IO::FileHandleCache cache;
+    EXPECT_FALSE(cache.open<IO::DesiredAccess::GenericRead>("missing").okay());
+    EXPECT_EQ(0u, cache.openHandles());
+}
+
+TEST(IO_FileHandleCache, MaxOpenConcurrent)
+{
+    const auto files = createTestFiles(8u);
+    IO::FileHandleCacheOptions options;
+    options.maxOpen = 2u;
+    IO::FileHandleCache cache{options};
+
+    std::mutex mutex;
+    std::vector<IO::FileHandleCache::Shared<IO::DesiredAccess::GenericRead>> held;
+    std::vector<std::thread> openers;
+    for(size_t index = 0u; index < files.size(); ++index)
+    {
+        openers.emplace_back([&, index]
+        {
+            auto opened = cache.open<IO::DesiredAccess::GenericRead>("test" + std::to_string(index));
+            if(opened.okay())
+            {
+                std::lock_guard lock{mutex};
+                held.push_back(std::move(opened).value());
+            }
+        });
+    }
+    for(auto& opener : openers)
+    {
+        opener.join();
+    }
+    EXPECT_EQ(2u, held.size());
+    EXPECT_EQ(2u, cache.openHandles());
+}
+
+TEST(IO_FileHandleCache, InvalidatedStillCounts)
+{
+    const auto files = createTestFiles(2u);
+    IO::FileHandleCacheOptions options;
+    options.maxOpen = 1u;
+    IO::FileHandleCache cache{options};
+
+    auto first = cache.open<IO::DesiredAccess::GenericRead>("test0");
+    ASSERT_TRUE(first.okay()) << first.message();
+    cache.invalidate("test0");
+    EXPECT_EQ(1u, cache.openHandles());
+    EXPECT_FALSE(cache.open<IO::DesiredAccess::GenericRead>("test1").okay());
+
+    first.value().reset();
+    EXPECT_EQ(0u, cache.openHandles());
+    EXPECT_TRUE(cache.open<IO::DesiredAccess::GenericRead>("test1").okay());
+}
+
+TEST(IO_FileHandleCache, InvalidatedWhileOpening)
+{
+    if constexpr(!Trace::Enabled)
+    {
+        GTEST_SKIP() << "needs CPP_WIN_API_TRACE to see when createFile ran";
+    }
+    const auto files = createTestFiles(1u);
+    IO::FileHandleCache cache;
+
+    for(size_t round = 0u; round < 2000u; ++round)
+    {
+        ASSERT_TRUE(Trace::eventLog().enable(16u));
+        std::atomic<bool> ready{false};
+        std::atomic<bool> go{false};
+        std::thread opener{[&]
+        {
+            ready.store(true);
+            while(!go.load())
+            {
+                std::this_thread::yield();
+            }
+            EXPECT_TRUE(cache.open<IO::DesiredAccess::GenericRead>("test0").okay());
+        }};
+        while(!ready.load())
+        {
+            std::this_thread::yield();
+        }
+        go.store(true);
+        for(size_t spin = 0u; spin < round % 64u; ++spin)
+        {
+            std::this_thread::yield();
+        }
+        const auto invalidated = Trace::Clock::now();
+        cache.invalidate("test0");
+        opener.join();
+        Trace::eventLog().disable();
+
+        Trace::eventLog().forEach([&](const Trace::Event& event)
+        {
+            if(event.site && event.site->name == "createFile" && event.start < invalidated)
+            {
+                // opened before the invalidation, so possibly the replaced file
+                EXPECT_EQ(0u, cache.openHandles()) << "round " << round;
+            }
+        });
+        cache.invalidate("test0");
+    }
+}
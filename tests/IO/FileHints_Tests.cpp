@@ -0,0 +1,70 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FileHints.h>
+#include <vector>
+
+using namespace WinApi;
+
+namespace
+{
+
+IO::FileAccessReadWrite createTestFile(const size_t size)
+{
+    auto file = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::Read | IO::ShareFlag::Write
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    ).value();
+    const std::vector<char> data(size, 'x');
+    IO::fileWriteData(file, data);
+    return file;
+}
+
+} // namespace
+
+TEST(IO_FileHints, PrefetchFileRange)
+{
+    const auto file = createTestFile(1024 * 1024);
+    const IO::FileRange range
+    {
+          .begin = Utils::CountOfBytes{} + Utils::OneByte * 300000
+        , .size  = Utils::CountOfBytes{} + Utils::OneByte * 500000
+    };
+    const auto prefetched = IO::prefetchFile(file, range);
+    EXPECT_TRUE(prefetched.okay()) << prefetched.message();
+}
+
+TEST(IO_FileHints, PrefetchAndEvictView)
+{
+    const auto file = createTestFile(256 * 1024);
+    auto mapping = IO::createFileMapping(file, IO::PageProtection::ReadOnly);
+    ASSERT_TRUE(mapping.okay()) << mapping.message();
+    auto view = IO::mapViewOfFile(  mapping.value()
+                                  , IO::ViewAccess::Read
+                                  , IO::FileRange{Utils::CountOfBytes{}, IO::getFileSize(file).value()});
+    ASSERT_TRUE(view.okay()) << view.message();
+
+    EXPECT_TRUE(IO::prefetchMemory(view.value().data).okay()) << lastErrorMessage();
+    EXPECT_EQ(std::byte{'x'}, view.value().data.back());
+    EXPECT_TRUE(IO::evictMemory(view.value().data).okay()) << lastErrorMessage();
+    EXPECT_EQ(std::byte{'x'}, view.value().data.front());
+}
+
+TEST(IO_FileHints, ReopenSequential)
+{
+    const auto file = createTestFile(4096);
+    auto reopened = IO::reopenFile(file, IO::AccessHint::Sequential);
+    ASSERT_TRUE(reopened.okay()) << reopened.message();
+
+    char buffer[4096]{};
+    const auto read = IO::fileReadAt(reopened.value(), Utils::CountOfBytes{}, std::begin(buffer), std::end(buffer));
+    ASSERT_TRUE(read.okay()) << read.message();
+    EXPECT_EQ(Utils::countOf(buffer), read.value());
+    EXPECT_EQ('x', buffer[4095]);
+}
@@ -0,0 +1,98 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FileInfo.h>
+#include <vector>
+
+using namespace WinApi;
+
+static IO::FileAccessReadWrite createTestFile(const char* const name, const size_t size)
+{
+    auto file = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          name
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    ).value();
+    const std::vector<std::byte> data(size, std::byte{7});
+    IO::fileWrite(file, data.data(), data.data() + data.size());
+    return file;
+}
+
+TEST(IO_FileInfo, HandleAndPath)
+{
+    const auto file = createTestFile("test", 1000u);
+
+    auto byHandle = IO::getFileInfo(file);
+    ASSERT_TRUE(byHandle.okay()) << byHandle.message();
+    EXPECT_EQ(1000u, static_cast<size_t>(byHandle.value().size));
+    EXPECT_FALSE(byHandle.value().isDirectory());
+
+    auto byPath = IO::getPathInfo("test");
+    ASSERT_TRUE(byPath.okay()) << byPath.message();
+    EXPECT_EQ(1000u, static_cast<size_t>(byPath.value().size));
+    EXPECT_TRUE(byHandle.value().id == byPath.value().id);
+    EXPECT_TRUE(byHandle.value().lastWrite == byPath.value().lastWrite);
+
+    auto directory = IO::getPathInfo(".");
+    ASSERT_TRUE(directory.okay()) << directory.message();
+    EXPECT_TRUE(directory.value().isDirectory());
+    EXPECT_FALSE(directory.value().id == byPath.value().id);
+}
+
+TEST(IO_FileInfo, Batch)
+{
+    const auto first = createTestFile("test0", 10u);
+    const auto second = createTestFile("test1", 20u);
+
+    const std::vector<std::filesystem::path> paths{"test0", "missing", "test1"};
+    const auto infos = IO::getPathsInfo(paths);
+    ASSERT_EQ(3u, infos.size());
+    ASSERT_TRUE(infos[0].okay());
+    EXPECT_EQ(10u, static_cast<size_t>(infos[0].value().size));
+    EXPECT_FALSE(infos[1].okay());
+    ASSERT_TRUE(infos[2].okay());
+    EXPECT_EQ(20u, static_cast<size_t>(infos[2].value().size));
+}
+
+TEST(IO_FileInfoCache, Invalidate)
+{
+    const auto file = createTestFile("test", 10u);
+    IO::FileInfoCache cache;
+
+    ASSERT_TRUE(cache.get("test").okay());
+    ASSERT_TRUE(cache.get("test").okay());
+    EXPECT_FALSE(cache.get("missing").okay());
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(1u, cache.stats().hits);
+    EXPECT_EQ(2u, cache.stats().misses);
+
+    const std::vector<std::byte> more(10u, std::byte{1});
+    IO::fileWrite(file, more.data(), more.data() + more.size());
+    EXPECT_EQ(10u, static_cast<size_t>(cache.get("test").value().size));
+
+    cache.invalidate("test");
+    EXPECT_EQ(20u, static_cast<size_t>(cache.get("test").value().size));
+    EXPECT_EQ(1u, cache.stats().invalidations);
+}
+
+TEST(IO_FileInfoCache, SpellingsShareEntry)
+{
+    const auto file = createTestFile("test", 10u);
+    IO::FileInfoCache cache;
+
+    ASSERT_TRUE(cache.get("test").okay());
+    ASSERT_TRUE(cache.get(std::filesystem::absolute("test")).okay());
+    ASSERT_TRUE(cache.get("./TEST").okay());
+    ASSERT_TRUE(cache.get("missing/../test").okay());
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(3u, cache.stats().hits);
+
+    cache.invalidate(std::filesystem::current_path() / "Test");
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(1u, cache.stats().invalidations);
+}
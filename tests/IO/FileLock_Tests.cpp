@@ -0,0 +1,74 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FileLock.h>
+#include <atomic>
+#include <thread>
+
+using namespace WinApi;
+
+static IO::FileRange bytes(const size_t begin, const size_t size)
+{
+    return IO::FileRange{Utils::CountOfBytes{} + Utils::OneByte * begin, Utils::CountOfBytes{} + Utils::OneByte * size};
+}
+
+TEST(IO_FileLock, ConflictingHandles)
+{
+    auto first = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    ).value();
+    auto second = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::OpenExisting
+        , IO::FileFlag::Normal
+    ).value();
+
+    {
+        auto locked = IO::lockFileRange(first, bytes(0u, 100u), IO::LockMode::Exclusive);
+        ASSERT_TRUE(locked.okay()) << locked.message();
+
+        auto conflict = IO::tryLockFileRange(second, bytes(50u, 100u), IO::LockMode::Shared);
+        EXPECT_FALSE(conflict.okay());
+        auto timedOut = IO::lockFileRange(second, bytes(50u, 100u), IO::LockMode::Shared, Milliseconds{20});
+        EXPECT_FALSE(timedOut.okay());
+
+        auto disjoint = IO::tryLockFileRange(second, bytes(100u, 100u), IO::LockMode::Exclusive);
+        EXPECT_TRUE(disjoint.okay()) << disjoint.message();
+    }
+
+    auto released = IO::tryLockFileRange(second, bytes(0u, 100u), IO::LockMode::Exclusive);
+    EXPECT_TRUE(released.okay()) << released.message();
+}
+
+TEST(IO_RangeLockTable, SharedAndExclusive)
+{
+    IO::RangeLockTable table;
+    auto shared = table.tryLock(bytes(0u, 100u), IO::LockMode::Shared);
+    ASSERT_TRUE(shared);
+    EXPECT_TRUE(table.tryLock(bytes(50u, 100u), IO::LockMode::Shared));
+    EXPECT_FALSE(table.tryLock(bytes(50u, 100u), IO::LockMode::Exclusive));
+    EXPECT_TRUE(table.tryLock(bytes(100u, 100u), IO::LockMode::Exclusive));
+    EXPECT_FALSE(table.lock(bytes(99u, 1u), IO::LockMode::Exclusive, Milliseconds{10}).okay());
+
+    std::atomic<bool> acquired{false};
+    std::jthread waiter{[&]
+    {
+        auto exclusive = table.lock(bytes(10u, 10u), IO::LockMode::Exclusive);
+        EXPECT_TRUE(exclusive.okay());
+        acquired = true;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    EXPECT_FALSE(acquired);
+    shared.unlock();
+    waiter.join();
+    EXPECT_TRUE(acquired);
+}
@@ -0,0 +1,51 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FileMapping.h>
+#include <algorithm>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(IO_FileMapping, ViewAtUnalignedOffset)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    std::vector<uint8_t> data(256 * 1024);
+    for(size_t index = 0u; index < data.size(); ++index)
+    {
+        data[index] = static_cast<uint8_t>(index % 251u);
+    }
+    ASSERT_EQ(Utils::countOf(data), IO::fileWriteData(file, data));
+
+    auto mapping = IO::createFileMapping(file, IO::PageProtection::ReadWrite);
+    ASSERT_TRUE(mapping.okay()) << mapping.message();
+
+    const IO::FileRange range
+    {
+          .begin = Utils::CountOfBytes{} + Utils::OneByte * 100000
+        , .size  = Utils::CountOfBytes{} + Utils::OneByte * 1000
+    };
+    auto view = IO::mapViewOfFile(mapping.value(), IO::ViewAccess::ReadWrite, range);
+    ASSERT_TRUE(view.okay()) << view.message();
+    ASSERT_EQ(1000u, view.value().data.size());
+    EXPECT_EQ(std::byte{100000u % 251u}, view.value().data[0]);
+    EXPECT_TRUE(std::equal(  data.begin() + 100000, data.begin() + 101000
+                           , reinterpret_cast<const uint8_t*>(view.value().data.data())));
+
+    view.value().data[0] = std::byte{0xFF};
+    uint8_t actual = 0u;
+    ASSERT_TRUE(IO::fileReadAt(file, range.begin, &actual, &actual + 1).okay());
+    EXPECT_EQ(0xFFu, actual);
+}
@@ -0,0 +1,60 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/FileSync.h>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(IO_FileSync, FlushAndSync)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    const std::vector<std::byte> data(10000u, std::byte{7});
+    ASSERT_EQ(Utils::countOf(data), IO::fileWriteData(file, data));
+
+    auto flushed = IO::flushFile(file);
+    EXPECT_TRUE(flushed.okay()) << flushed.message();
+    auto synced = IO::syncFileData(file);
+    EXPECT_TRUE(synced.okay()) << synced.message();
+    auto ranged = IO::syncFileRange(file, IO::FileRange{Utils::CountOfBytes{}, Utils::CountOfBytes{} + Utils::OneByte * 4096});
+    EXPECT_TRUE(ranged.okay()) << ranged.message();
+}
+
+TEST(IO_FileSync, FlushAsync)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    const std::vector<std::byte> data(10000u, std::byte{7});
+    ASSERT_EQ(Utils::countOf(data), IO::fileWriteData(file, data));
+
+    auto maybeTask = IO::flushFileAsync(file);
+    ASSERT_TRUE(maybeTask.okay()) << maybeTask.message();
+    auto task = std::move(maybeTask).value();
+    file.reset();
+
+    auto waited = waitFor(task.event());
+    ASSERT_TRUE(waited.okay()) << waited.message();
+    EXPECT_EQ(WaitStatus::Object0, waited.value());
+    auto result = IO::flushResult(task);
+    EXPECT_TRUE(result.okay()) << result.message();
+}
@@ -0,0 +1,92 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/LogWriter.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(IO_LogWriter, GroupCommit)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Normal
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+
+    constexpr size_t Threads = 8u;
+    constexpr size_t Records = 200u;
+    IO::LogWriterOptions options;
+    options.batchWindow = std::chrono::milliseconds{1};
+    {
+        IO::LogWriter log{std::move(maybeFile).value(), options};
+        {
+            std::vector<std::jthread> threads;
+            for(size_t thread = 0u; thread < Threads; ++thread)
+            {
+                threads.emplace_back([&, thread]
+                {
+                    const std::vector<std::byte> record(16u, static_cast<std::byte>('a' + thread));
+                    for(size_t index = 0u; index < Records; ++index)
+                    {
+                        EXPECT_TRUE(log.append(record).okay());
+                    }
+                });
+            }
+        }
+
+        const auto& stats = log.stats();
+        EXPECT_EQ(Threads * Records, stats.records.load());
+        EXPECT_EQ(Threads * Records * 16u, stats.bytes.load());
+        EXPECT_LE(stats.flushes.load(), Threads * Records);
+        EXPECT_GE(stats.recordsPerFlush(), 1.0);
+    }
+
+    auto file = IO::createFile<IO::DesiredAccess::GenericRead>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::OpenExisting
+        , IO::FileFlag::DeleteOnClose
+    ).value();
+    std::vector<std::byte> content(Threads * Records * 16u + 1u);
+    ASSERT_EQ(Utils::CountOfBytes{} + Utils::OneByte * (Threads * Records * 16u), IO::fileReadData(file, content));
+    for(size_t record = 0u; record < Threads * Records; ++record)
+    {
+        const auto begin = content.begin() + record * 16u;
+        EXPECT_TRUE(std::all_of(begin, begin + 16, [&](const std::byte value){ return value == *begin; }));
+    }
+}
+
+TEST(IO_LogWriter, StopsAfterFailedWrite)
+{
+    // unbuffered writes of a partial sector fail
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose | IO::FileFlag::NoBuffering
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+
+    IO::LogWriter log{std::move(maybeFile).value()};
+    const std::vector<std::byte> record(16u, std::byte{1});
+    const auto failed = log.append(record);
+    ASSERT_FALSE(failed.okay());
+    EXPECT_EQ(1u, log.stats().flushes.load());
+
+    // a later record would land after whatever part of the batch was written
+    const auto rejected = log.append(record);
+    ASSERT_FALSE(rejected.okay());
+    EXPECT_EQ(failed.code().code(), rejected.code().code());
+    EXPECT_EQ(1u, log.stats().flushes.load());
+}
@@ -0,0 +1,174 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/ParallelRead.h>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(IO_ParallelRead, ChunksLandInPlace)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    std::vector<std::byte> data(100000u);
+    for(size_t index = 0u; index < data.size(); ++index)
+    {
+        data[index] = static_cast<std::byte>(index * 7u + index / 251u);
+    }
+    ASSERT_EQ(Utils::countOf(data), IO::fileWriteData(file, data));
+
+    std::mutex mutex;
+    size_t reported = 0u;
+    IO::ParallelReadOptions options;
+    options.chunkSize = Utils::CountOfBytes{} + Utils::OneByte * 4096;
+    options.workers = 4u;
+    options.onChunk = [&](const IO::FileChunk& chunk)
+    {
+        std::lock_guard lock{mutex};
+        EXPECT_EQ(static_cast<size_t>(chunk.range.size), chunk.data.size());
+        reported += chunk.data.size();
+    };
+
+    const size_t offset = 1000u;
+    std::vector<std::byte> buffer(data.size() - offset);
+    const auto results = IO::parallelReadFile(file, std::span{buffer}, Utils::CountOfBytes{} + Utils::OneByte * offset, options);
+
+    EXPECT_EQ((data.size() + 4095u) / 4096u, results.size());
+    size_t total = 0u;
+    for(const auto& read : results)
+    {
+        ASSERT_TRUE(read.okay()) << read.message();
+        total += static_cast<size_t>(read.value());
+    }
+    EXPECT_EQ(buffer.size(), total);
+    EXPECT_EQ(buffer.size(), reported);
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), data.begin() + offset));
+}
+
+TEST(IO_ParallelRead, ShortReadPastEnd)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    const std::vector<std::byte> data(3000u, std::byte{42});
+    ASSERT_EQ(Utils::countOf(data), IO::fileWriteData(file, data));
+
+    IO::ParallelReadOptions options;
+    options.chunkSize = Utils::CountOfBytes{} + Utils::OneByte * 1024;
+    std::vector<std::byte> buffer(4096u);
+    const auto results = IO::parallelReadFile(file, std::span{buffer}, Utils::CountOfBytes{}, options);
+
+    ASSERT_EQ(4u, results.size());
+    EXPECT_EQ(Utils::CountOfBytes{} + Utils::OneByte * 1024, results[1].value());
+    EXPECT_EQ(Utils::CountOfBytes{} + Utils::OneByte * 952, results[2].value());
+    EXPECT_EQ(Utils::CountOfBytes{}, results[3].value());
+}
+
+TEST(IO_ParallelRead, CallerThreadRestored)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    const std::vector<std::byte> data(8192u, std::byte{1});
+    ASSERT_EQ(Utils::countOf(data), IO::fileWriteData(file, data));
+
+    const ThreadPriority priority = getThreadPriority(::GetCurrentThread()).value();
+    IO::ParallelReadOptions options;
+    options.chunkSize = Utils::CountOfBytes{} + Utils::OneByte * 1024;
+    options.workers = 2u;
+    options.onWorkerStart = pinWorkers({}, ThreadPriority::Lowest);
+    std::vector<std::byte> buffer(data.size());
+    IO::parallelReadFile(file, std::span{buffer}, Utils::CountOfBytes{}, options);
+
+    EXPECT_EQ(priority, getThreadPriority(::GetCurrentThread()).value());
+}
+
+TEST(IO_ParallelRead, OverlappedReadsOverlap)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    std::vector<std::byte> data(64u * 4096u);
+    for(size_t index = 0u; index < data.size(); ++index)
+    {
+        data[index] = static_cast<std::byte>(index * 13u + index / 4099u);
+    }
+    ASSERT_EQ(Utils::countOf(data), IO::fileWriteData(file, data));
+
+    auto maybeOverlapped = IO::createFile<IO::DesiredAccess::GenericRead>
+    (
+          "test"
+        , IO::ShareFlag::Read | IO::ShareFlag::Write | IO::ShareFlag::Delete
+        , IO::CreateMode::OpenExisting
+        , IO::FileFlag::Overllaped
+    );
+    ASSERT_TRUE(maybeOverlapped.okay()) << maybeOverlapped.message();
+    const auto overlapped = std::move(maybeOverlapped).value();
+
+    ASSERT_TRUE(!Trace::Enabled || Trace::eventLog().enable(1024u));
+    IO::ParallelReadOptions options;
+    options.chunkSize = Utils::CountOfBytes{} + Utils::OneByte * 4096;
+    options.workers = 4u;
+    std::vector<std::byte> buffer(data.size());
+    const auto results = IO::parallelReadFile(overlapped, std::span{buffer}, Utils::CountOfBytes{}, options);
+    Trace::eventLog().disable();
+
+    for(const auto& read : results)
+    {
+        ASSERT_TRUE(read.okay()) << read.message();
+    }
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), data.begin()));
+
+    if constexpr(Trace::Enabled)
+    {
+        std::vector<Trace::Event> reads;
+        Trace::eventLog().forEach([&](const Trace::Event& event)
+        {
+            if(event.site && event.site->name == "fileReadAt")
+            {
+                reads.push_back(event);
+            }
+        });
+        std::sort(reads.begin(), reads.end(), [](const auto& left, const auto& right){ return left.start < right.start; });
+        bool overlapping = false;
+        for(size_t index = 1u; index < reads.size(); ++index)
+        {
+            overlapping = overlapping || reads[index].start < reads[index - 1u].start + reads[index - 1u].duration;
+        }
+        EXPECT_TRUE(overlapping);
+    }
+}
@@ -0,0 +1,45 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/RecordReader.h>
+#include <string>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(IO_RecordReader, RecordsStraddleReads)
+{
+    auto maybeFile = IO::createFile<IO::DesiredAccess::GenericReadWrite>
+    (
+          "test"
+        , IO::ShareFlag::None
+        , IO::CreateMode::CreateAlways
+        , IO::FileFlag::Temporary | IO::FileFlag::DeleteOnClose
+    );
+    ASSERT_TRUE(maybeFile.okay()) << maybeFile.message();
+    auto file = std::move(maybeFile).value();
+
+    std::vector<std::string> expected;
+    std::string text;
+    for(size_t index = 0u; index < 500u; ++index)
+    {
+        expected.push_back(std::string(index % 37u, 'a' + index % 26u));
+        text += expected.back() + '\n';
+    }
+    expected.push_back(std::string(100u, 'z')); // longer than the buffer and unterminated
+    text += expected.back();
+    ASSERT_EQ(Utils::countOf(text), IO::fileWriteData(file, text));
+    ASSERT_TRUE(IO::setFilePointerToBegin(file).okay());
+
+    std::vector<std::string> actual;
+    const auto read = IO::fileReadRecords(file, IO::RecordSplitter{}, [&](const std::span<const std::byte> record)
+    {
+        actual.emplace_back(reinterpret_cast<const char*>(record.data()), record.size());
+    }, Utils::CountOfBytes{} + Utils::OneByte * 16);
+
+    EXPECT_EQ(Utils::sizeOf(Utils::countOf(text)), read);
+    EXPECT_EQ(expected, actual);
+}
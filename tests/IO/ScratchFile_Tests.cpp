@@ -0,0 +1,69 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/ScratchFile.h>
+#include <vector>
+
+using namespace WinApi;
+
+// Scratch code written against the file functions only.
+template<typename F>
+std::vector<uint32_t> writeAndReadBack(const F& file, const std::vector<uint32_t>& values)
+{
+    IO::fileWrite(file, values.data(), values.data() + values.size());
+    IO::setFilePointer(file, IO::OffsetOfBytes{}, IO::FilePointerFrom::Begin);
+    std::vector<uint32_t> back(values.size());
+    IO::fileReadData(file, back);
+    return back;
+}
+
+TEST(IO_ScratchFile, StaysInMemory)
+{
+    const auto scratch = IO::createScratchFile();
+    const std::vector<uint32_t> values{1u, 2u, 3u, 4u};
+    EXPECT_EQ(values, writeAndReadBack(scratch, values));
+    EXPECT_FALSE(scratch.spilled());
+    EXPECT_EQ(16u, static_cast<size_t>(IO::getFileSize(scratch).value()));
+
+    uint32_t last = 0u;
+    const auto position = IO::setFilePointer(scratch, IO::OffsetOfBytes{} - IO::OneByte * 4, IO::FilePointerFrom::End);
+    ASSERT_TRUE(position.okay()) << position.message();
+    EXPECT_EQ(12u, static_cast<size_t>(position.value()));
+    EXPECT_EQ(1u, static_cast<size_t>(IO::fileReadValue(scratch, last)));
+    EXPECT_EQ(4u, last);
+    EXPECT_EQ(0u, static_cast<size_t>(IO::fileReadValue(scratch, last)));
+
+    EXPECT_FALSE(IO::setFilePointer(scratch, IO::OffsetOfBytes{} - IO::OneByte * 1, IO::FilePointerFrom::Begin).okay());
+}
+
+TEST(IO_ScratchFile, SpillsPastThreshold)
+{
+    IO::ScratchFileOptions options;
+    options.spillSize = IO::CountOfBytes{} + IO::OneByte * 64;
+    const auto scratch = IO::createScratchFile(options);
+
+    std::vector<uint32_t> values(10u);
+    for(uint32_t index = 0u; index < values.size(); ++index)
+    {
+        values[index] = index;
+    }
+    EXPECT_EQ(values, writeAndReadBack(scratch, values));
+    EXPECT_FALSE(scratch.spilled());
+
+    // the position is kept across the spill
+    IO::setFilePointer(scratch, IO::OffsetOfBytes{} + IO::OneByte * 40, IO::FilePointerFrom::Begin);
+    values.assign(20u, 7u);
+    IO::fileWrite(scratch, values.data(), values.data() + values.size());
+    EXPECT_TRUE(scratch.spilled());
+    EXPECT_EQ(120u, static_cast<size_t>(IO::getFileSize(scratch).value()));
+
+    std::vector<uint32_t> back(30u);
+    IO::setFilePointer(scratch, IO::OffsetOfBytes{}, IO::FilePointerFrom::Begin);
+    EXPECT_EQ(30u, static_cast<size_t>(IO::fileReadData(scratch, back)));
+    EXPECT_EQ(9u, back[9]);
+    EXPECT_EQ(7u, back[10]);
+    EXPECT_EQ(7u, back[29]);
+}
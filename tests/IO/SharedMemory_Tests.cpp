@@ -0,0 +1,34 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/SharedMemory.h>
+
+using namespace WinApi;
+
+TEST(IO_SharedMemory, CreateAndOpenByName)
+{
+    const auto size = Utils::CountOfBytes{} + Utils::OneByte * 4096;
+    const auto range = IO::FileRange{Utils::CountOfBytes{}, size};
+
+    auto maybeCreated = IO::createSharedMemory(TEXT("CppWinApi.SharedMemory.Test"), size);
+    ASSERT_TRUE(maybeCreated.okay()) << maybeCreated.message();
+    auto created = std::move(maybeCreated).value();
+
+    auto maybeOpened = IO::openSharedMemory(TEXT("CppWinApi.SharedMemory.Test"));
+    ASSERT_TRUE(maybeOpened.okay()) << maybeOpened.message();
+    auto opened = std::move(maybeOpened).value();
+
+    auto writer = IO::mapViewOfFile(created, IO::ViewAccess::ReadWrite, range).value();
+    auto reader = IO::mapViewOfFile(opened, IO::ViewAccess::Read, range).value();
+    writer.data[100] = std::byte{42};
+    EXPECT_EQ(std::byte{42}, reader.data[100]);
+}
+
+TEST(IO_SharedMemory, OpenMissing)
+{
+    auto maybeOpened = IO::openSharedMemory(TEXT("CppWinApi.SharedMemory.Missing"));
+    EXPECT_FALSE(maybeOpened.okay());
+}
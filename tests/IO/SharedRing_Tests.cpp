@@ -0,0 +1,59 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/IO/SharedRing.h>
+#include <thread>
+
+using namespace WinApi;
+
+TEST(IO_SharedRing, ProducerConsumer)
+{
+    auto maybeProducer = IO::SharedRing::create(TEXT("CppWinApi.SharedRing.Test"), Utils::CountOfBytes{} + Utils::OneByte * 256);
+    ASSERT_TRUE(maybeProducer.okay()) << maybeProducer.message();
+    auto producer = std::move(maybeProducer).value();
+
+    auto maybeConsumer = IO::SharedRing::open(TEXT("CppWinApi.SharedRing.Test"));
+    ASSERT_TRUE(maybeConsumer.okay()) << maybeConsumer.message();
+    auto consumer = std::move(maybeConsumer).value();
+
+    constexpr size_t Count = 10000u;
+    std::jthread writer{[&]
+    {
+        std::vector<std::byte> message;
+        for(size_t index = 0u; index < Count; ++index)
+        {
+            message.assign(index % 50u, static_cast<std::byte>(index));
+            EXPECT_TRUE(producer.write(message).okay());
+        }
+    }};
+
+    std::vector<std::byte> message;
+    for(size_t index = 0u; index < Count; ++index)
+    {
+        ASSERT_TRUE(consumer.read(message).okay());
+        ASSERT_EQ(index % 50u, message.size());
+        EXPECT_TRUE(std::all_of(message.begin(), message.end(), [&](const std::byte value)
+        {
+            return value == static_cast<std::byte>(index);
+        }));
+    }
+    EXPECT_FALSE(consumer.tryRead(message));
+}
+
+TEST(IO_SharedRing, Timeout)
+{
+    auto maybeRing = IO::SharedRing::create(TEXT("CppWinApi.SharedRing.Timeout"), Utils::CountOfBytes{} + Utils::OneByte * 64);
+    ASSERT_TRUE(maybeRing.okay()) << maybeRing.message();
+    auto ring = std::move(maybeRing).value();
+
+    std::vector<std::byte> message;
+    const auto read = ring.read(message, Milliseconds{10});
+    ASSERT_FALSE(read.okay());
+    EXPECT_EQ(std::error_code(ERROR_TIMEOUT, std::system_category()), read.code().code());
+
+    const std::vector<std::byte> big(ring.maxMessageSize() + 1u);
+    EXPECT_FALSE(ring.write(big).okay());
+}
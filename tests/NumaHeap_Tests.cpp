@@ -0,0 +1,57 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/NumaHeap.h>
+#include <string>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(NumaHeap, EmplaceAndRecycle)
+{
+    // One object per slab, so the heap has to grow.
+    auto maybeHeap = createNumaHeap<std::string>(0u, Utils::countOf<std::string>(Utils::sizeOf<std::string>()));
+    ASSERT_TRUE(maybeHeap.okay()) << maybeHeap.message();
+    auto heap = std::move(maybeHeap).value();
+    EXPECT_EQ(0u, heap.node());
+
+    std::vector<NumaHeap<std::string>::Instance> instances;
+    for(size_t index = 0u; index < 10u; ++index)
+    {
+        auto instance = numaHeapEmplace(heap, std::to_string(index));
+        ASSERT_TRUE(instance.okay()) << instance.message();
+        instances.push_back(std::move(instance).value());
+    }
+    for(size_t index = 0u; index < instances.size(); ++index)
+    {
+        EXPECT_EQ(std::to_string(index), *instances[index]);
+    }
+
+    const std::string* const last = instances.back().get();
+    instances.pop_back();
+    EXPECT_EQ(last, heap.emplace("again").value().get());
+}
+
+TEST(NumaHeap, InvalidNode)
+{
+    EXPECT_FALSE(createNumaHeap<int>(static_cast<DWORD>(numaNodeCount())).okay());
+}
+
+TEST(NumaHeap, SetPicksLocalNode)
+{
+    NumaHeapSet<int> heaps;
+    ASSERT_EQ(numaNodeCount(), heaps.nodes());
+    EXPECT_EQ(currentNumaNode(), heaps.local().node());
+
+    auto local = heaps.emplace(42);
+    ASSERT_TRUE(local.okay()) << local.message();
+    EXPECT_EQ(42, *local.value());
+
+    // A node without memory of its own still serves allocations.
+    auto remote = heaps.onNode(heaps.nodes() - 1u).emplace(7);
+    ASSERT_TRUE(remote.okay()) << remote.message();
+    EXPECT_EQ(7, *remote.value());
+}
@@ -0,0 +1,80 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/Sync/Barrier.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(Sync_Barrier, Phases)
+{
+    constexpr size_t Threads = 4u;
+    Sync::Barrier barrier{Threads};
+    std::atomic<size_t> arrived{0u};
+    std::atomic<size_t> serial{0u};
+    {
+        std::vector<std::jthread> threads;
+        for(size_t thread = 0u; thread < Threads; ++thread)
+        {
+            threads.emplace_back([&]
+            {
+                for(size_t phase = 1u; phase <= 3u; ++phase)
+                {
+                    ++arrived;
+                    if(barrier.arriveAndWait())
+                    {
+                        ++serial;
+                    }
+                    EXPECT_GE(arrived.load(), phase * Threads);
+                    barrier.arriveAndWait();
+                }
+            });
+        }
+    }
+    EXPECT_EQ(3u, serial.load());
+}
+
+TEST(Sync_Latch, FanOutFanIn)
+{
+    constexpr size_t Tasks = 64u;
+    auto maybeLatch = Sync::Latch::create(Tasks);
+    ASSERT_TRUE(maybeLatch.okay()) << maybeLatch.message();
+    Sync::Latch latch = std::move(maybeLatch).value();
+
+    std::atomic<size_t> finished{0u};
+    std::vector<std::jthread> threads;
+    for(size_t task = 0u; task < Tasks; ++task)
+    {
+        threads.emplace_back([&]
+        {
+            ++finished;
+            EXPECT_TRUE(latch.countDown().okay());
+        });
+    }
+    const auto joined = latch.wait();
+    ASSERT_TRUE(joined.okay()) << joined.message();
+    EXPECT_EQ(WaitStatus::Object0, joined.value());
+    EXPECT_EQ(Tasks, finished.load());
+    EXPECT_TRUE(latch.tryWait());
+    EXPECT_EQ(WaitStatus::Object0, waitFor(latch.event(), Milliseconds{0}).value());
+}
+
+TEST(Sync_Latch, DestroyedRightAfterWait)
+{
+    for(size_t round = 0u; round < 200u; ++round)
+    {
+        auto latch = std::make_unique<Sync::Latch>(Sync::Latch::create(1).value());
+        std::jthread arrival{[&latch]
+        {
+            EXPECT_TRUE(latch->countDown().okay());
+        }};
+        ASSERT_EQ(WaitStatus::Object0, latch->wait().value());
+        latch.reset();
+    }
+}
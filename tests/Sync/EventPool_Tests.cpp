@@ -0,0 +1,106 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/Sync/EventPool.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(Sync_EventPool, RecyclesResetEvents)
+{
+    Sync::ManualEventPool pool;
+    HANDLE first = nullptr;
+    {
+        auto event = pool.acquire();
+        ASSERT_TRUE(event.okay()) << event.message();
+        first = event.value().get().get();
+        EXPECT_TRUE(Sync::setEvent(event.value().get()).okay());
+    }
+    auto again = pool.acquire();
+    ASSERT_TRUE(again.okay()) << again.message();
+    EXPECT_EQ(first, again.value().get().get());
+    EXPECT_EQ(WaitStatus::Timeout, waitFor(again.value().get(), Milliseconds{0}).value());
+    EXPECT_EQ(1u, pool.createdEvents());
+}
+
+TEST(Sync_EventPool, HighWaterMark)
+{
+    Sync::AutoEventPool pool{Sync::EventPoolOptions{.highWaterMark = 4u, .threadCache = 2u}};
+    {
+        std::vector<Sync::AutoEventPool::Pooled> events;
+        for(size_t index = 0u; index < 10u; ++index)
+        {
+            events.push_back(std::move(pool.acquire()).value());
+        }
+    }
+    EXPECT_EQ(10u, pool.createdEvents());
+    EXPECT_EQ(4u, pool.idleEvents());
+
+    std::jthread other{[&]
+    {
+        for(size_t index = 0u; index < 100u; ++index)
+        {
+            auto event = pool.acquire();
+            EXPECT_TRUE(event.okay());
+        }
+    }};
+    other.join();
+    EXPECT_EQ(10u, pool.createdEvents());
+}
+
+TEST(Sync_EventPool, ThreadCachesCount)
+{
+    Sync::ManualEventPool pool{Sync::EventPoolOptions{.highWaterMark = 8u, .threadCache = 2u}};
+    std::jthread other{[&]
+    {
+        auto first = pool.acquire();
+        auto second = pool.acquire();
+        auto third = pool.acquire();
+        EXPECT_TRUE(third.okay());
+    }};
+    other.join();
+    // two went to the cache of the other thread and are closed with it
+    EXPECT_EQ(3u, pool.createdEvents());
+    EXPECT_EQ(1u, pool.idleEvents());
+
+    {
+        std::vector<Sync::ManualEventPool::Pooled> events;
+        for(size_t index = 0u; index < 10u; ++index)
+        {
+            events.push_back(std::move(pool.acquire()).value());
+        }
+    }
+    EXPECT_EQ(12u, pool.createdEvents());
+    EXPECT_EQ(8u, pool.idleEvents()); // the thread cache counts against the high water mark
+}
+
+TEST(Sync_EventPool, DestroyedPoolClosesThreadCache)
+{
+    auto pool = std::make_unique<Sync::ManualEventPool>(Sync::EventPoolOptions{.threadCache = 2u});
+    std::vector<HANDLE> handles;
+    {
+        std::vector<Sync::ManualEventPool::Pooled> events;
+        for(size_t index = 0u; index < 2u; ++index)
+        {
+            events.push_back(std::move(pool->acquire()).value());
+            handles.push_back(events.back().get().get());
+        }
+    }
+    EXPECT_EQ(2u, pool->idleEvents());
+
+    // this thread lives on, its cache for the pool must not
+    pool.reset();
+    for(const HANDLE handle : handles)
+    {
+        DWORD flags = 0u;
+        EXPECT_EQ(FALSE, ::GetHandleInformation(handle, &flags));
+    }
+
+    Sync::ManualEventPool other;
+    EXPECT_TRUE(other.acquire().okay());
+}
@@ -0,0 +1,67 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/Sync/Lock.h>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+using namespace WinApi;
+
+template<typename L>
+static size_t hammer(L& lock)
+{
+    size_t counter = 0u;
+    {
+        std::vector<std::jthread> threads;
+        for(size_t thread = 0u; thread < 4u; ++thread)
+        {
+            threads.emplace_back([&]
+            {
+                for(size_t index = 0u; index < 10000u; ++index)
+                {
+                    std::lock_guard guard{lock};
+                    ++counter;
+                }
+            });
+        }
+    }
+    return counter;
+}
+
+TEST(Sync_Lock, SrwExclusive)
+{
+    Sync::CountedSrwLock lock{100u};
+    EXPECT_EQ(40000u, hammer(lock));
+    EXPECT_EQ(40000u, lock.stats().acquisitions.load());
+    EXPECT_LE(lock.stats().contended.load(), 40000u);
+}
+
+TEST(Sync_Lock, SrwShared)
+{
+    Sync::SrwLock lock;
+    static_assert(sizeof(Sync::SrwLock) <= 2 * sizeof(void*));
+    {
+        std::shared_lock first{lock};
+        std::shared_lock second{lock};
+        EXPECT_FALSE(lock.try_lock());
+    }
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock_shared());
+    lock.unlock();
+}
+
+TEST(Sync_Lock, CriticalSection)
+{
+    Sync::CountedCriticalSection lock;
+    EXPECT_EQ(40000u, hammer(lock));
+    EXPECT_EQ(40000u, lock.stats().acquisitions.load());
+
+    std::lock_guard outer{lock};
+    std::lock_guard inner{lock};
+    EXPECT_EQ(40002u, lock.stats().acquisitions.load());
+}
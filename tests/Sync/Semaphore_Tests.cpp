@@ -0,0 +1,24 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/Sync/Semaphore.h>
+
+using namespace WinApi;
+
+TEST(Sync_Semaphore, AcquireThroughWaitFor)
+{
+    auto maybeSemaphore = Sync::createSemaphore(1, 2);
+    ASSERT_TRUE(maybeSemaphore.okay()) << maybeSemaphore.message();
+    Sync::Semaphore semaphore = std::move(maybeSemaphore).value();
+
+    EXPECT_EQ(WaitStatus::Object0, waitFor(semaphore, Milliseconds{0}).value());
+    EXPECT_EQ(WaitStatus::Timeout, waitFor(semaphore, Milliseconds{0}).value());
+
+    EXPECT_EQ(0, Sync::releaseSemaphore(semaphore, 2).value());
+    EXPECT_FALSE(Sync::releaseSemaphore(semaphore).okay());
+    EXPECT_EQ(WaitStatus::Object0, waitFor(semaphore, Milliseconds{0}).value());
+    EXPECT_EQ(WaitStatus::Object0, waitFor(semaphore, Milliseconds{0}).value());
+}
@@ -0,0 +1,56 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/Thread.h>
+#include <thread>
+
+using namespace WinApi;
+
+TEST(Thread, PriorityAndAffinity)
+{
+    std::jthread worker{[]
+    {
+        ASSERT_TRUE(setCurrentThreadPriority(ThreadPriority::BelowNormal).okay());
+        EXPECT_EQ(ThreadPriority::BelowNormal, getThreadPriority(::GetCurrentThread()).value());
+
+        const auto cpus = queryTopology().value().spreadCpus();
+        ASSERT_FALSE(cpus.empty());
+        const auto previous = setCurrentThreadAffinity(cpus.back());
+        ASSERT_TRUE(previous.okay()) << previous.message();
+        const CpuSet current = getThreadAffinity(::GetCurrentThread()).value();
+        EXPECT_EQ(cpus.back().Group, current.Group);
+        EXPECT_EQ(cpus.back().Mask, current.Mask);
+    }};
+}
+
+TEST(Thread, PinWorkers)
+{
+    const auto cpus = queryTopology().value().spreadCpus();
+    const WorkerStart start = pinWorkers(cpus, ThreadPriority::AboveNormal);
+    std::jthread worker{[&]
+    {
+        start(1u);
+        EXPECT_EQ(cpus[1u % cpus.size()].Mask, getThreadAffinity(::GetCurrentThread()).value().Mask);
+        EXPECT_EQ(ThreadPriority::AboveNormal, getThreadPriority(::GetCurrentThread()).value());
+    }};
+}
+
+TEST(Thread, StateRestore)
+{
+    const auto cpus = queryTopology().value().spreadCpus();
+    std::jthread worker{[&]
+    {
+        const CpuSet affinity = getThreadAffinity(::GetCurrentThread()).value();
+        const ThreadPriority priority = getThreadPriority(::GetCurrentThread()).value();
+        {
+            const ThreadStateRestore restore;
+            pinWorkers(cpus, ThreadPriority::Highest)(0u);
+            EXPECT_EQ(ThreadPriority::Highest, getThreadPriority(::GetCurrentThread()).value());
+        }
+        EXPECT_EQ(affinity.Mask, getThreadAffinity(::GetCurrentThread()).value().Mask);
+        EXPECT_EQ(priority, getThreadPriority(::GetCurrentThread()).value());
+    }};
+}
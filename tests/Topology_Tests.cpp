@@ -0,0 +1,44 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/Topology.h>
+#include <set>
+
+using namespace WinApi;
+
+TEST(Topology, Query)
+{
+    auto maybeTopology = queryTopology();
+    ASSERT_TRUE(maybeTopology.okay()) << maybeTopology.message();
+    const Topology& topology = maybeTopology.value();
+
+    ASSERT_FALSE(topology.cores.empty());
+    ASSERT_FALSE(topology.packages.empty());
+    ASSERT_FALSE(topology.nodes.empty());
+    EXPECT_GE(topology.logicalProcessors(), topology.cores.size());
+    for(const CpuCore& core : topology.cores)
+    {
+        EXPECT_LT(core.package, topology.packages.size());
+        EXPECT_LT(core.node, topology.nodes.size());
+    }
+
+    const auto spread = topology.spreadCpus();
+    ASSERT_EQ(topology.logicalProcessors(), spread.size());
+    std::set<size_t> firstCores;
+    for(size_t index = 0u; index < topology.cores.size(); ++index)
+    {
+        EXPECT_EQ(1u, cpuCount(spread[index]));
+        for(size_t core = 0u; core < topology.cores.size(); ++core)
+        {
+            if(intersects(spread[index], topology.cores[core].cpus))
+            {
+                firstCores.insert(core);
+            }
+        }
+    }
+    EXPECT_EQ(topology.cores.size(), firstCores.size());
+    EXPECT_FALSE(topology.nodeCpus(0u).empty());
+}
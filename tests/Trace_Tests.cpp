@@ -0,0 +1,160 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+
+#include <gtest/gtest.h>
+
+#include <WinApi/Trace.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace WinApi;
+
+TEST(Trace, HistogramBuckets)
+{
+    using namespace std::chrono_literals;
+    static_assert(Trace::Histogram::bucketOf(0ns) == 0u);
+    static_assert(Trace::Histogram::bucketOf(1ns) == 0u);
+    static_assert(Trace::Histogram::bucketOf(1024ns) == 10u);
+    static_assert(Trace::Histogram::bucketOf(1s) == 29u);
+
+    Trace::Histogram histogram;
+    histogram.record(100ns);
+    histogram.record(100ns);
+    histogram.record(5ms);
+    EXPECT_EQ(2u, histogram.count(Trace::Histogram::bucketOf(100ns)));
+    EXPECT_EQ(Trace::Histogram::lowerBound(6u), histogram.percentile(0.5));
+    EXPECT_EQ(Trace::Histogram::lowerBound(22u), histogram.percentile(0.99));
+}
+
+TEST(Trace, ScopeRecordsSite)
+{
+    static Trace::Site site{"Trace.ScopeRecordsSite"};
+    {
+        Trace::BasicScope<true> scope{site};
+        scope.bytes(137u);
+    }
+    {
+        Trace::BasicScope<true> scope{site};
+        scope.failed();
+    }
+    EXPECT_EQ(2u, site.calls.load());
+    EXPECT_EQ(137u, site.bytes.load());
+    EXPECT_EQ(1u, site.failures.load());
+
+    bool registered = false;
+    Trace::Site::forEach([&](const Trace::Site& each)
+    {
+        registered = registered || &each == &site;
+    });
+    EXPECT_TRUE(registered);
+}
+
+namespace
+{
+
+template<typename T>
+void tracedTwice()
+{
+    WINAPI_TRACE_SCOPE(trace, "Trace.SitesByName");
+    trace.bytes(sizeof(T));
+}
+
+} // namespace
+
+TEST(Trace, SitesByName)
+{
+    Trace::Site& site = Trace::Site::named("Trace.SitesByName");
+    EXPECT_EQ(&site, &Trace::Site::named("Trace.SitesByName"));
+    EXPECT_NE(&site, &Trace::Site::named("Trace.SitesByName.Other"));
+
+    tracedTwice<char>();
+    tracedTwice<uint64_t>();
+    if constexpr(Trace::Enabled)
+    {
+        // both instantiations count in the one site
+        EXPECT_EQ(2u, site.calls.load());
+        EXPECT_EQ(9u, site.bytes.load());
+    }
+}
+
+TEST(Trace, DisabledScopeIsEmpty)
+{
+    static_assert(std::is_empty_v<Trace::BasicScope<false>>);
+    static_assert(std::is_trivially_destructible_v<Trace::BasicScope<false>>);
+}
+
+TEST(Trace, ChromeTraceExport)
+{
+    static Trace::Site site{"Trace.ChromeTraceExport"};
+    Trace::EventLog log;
+    ASSERT_TRUE(log.enable(3u));
+    for(uint64_t bytes = 1u; bytes <= 5u; ++bytes)
+    {
+        log.record(Trace::Event{.site = &site, .bytes = bytes});
+    }
+
+    size_t kept = 0u;
+    log.forEach([&](const Trace::Event& event)
+    {
+        EXPECT_LT(1u, event.bytes);
+        ++kept;
+    });
+    EXPECT_EQ(4u, kept);
+
+    std::ostringstream out;
+    Trace::exportChromeTrace(out, log);
+    const std::string json = out.str();
+    EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"Trace.ChromeTraceExport\""));
+    EXPECT_NE(std::string::npos, json.find("\"args\":{\"bytes\":5}"));
+}
+
+TEST(Trace, EventLogEnableWhileActive)
+{
+    static Trace::Site site{"Trace.EventLogEnableWhileActive"};
+    Trace::EventLog log;
+    ASSERT_TRUE(log.enable(4u));
+    log.record(Trace::Event{.site = &site, .bytes = 1u});
+    EXPECT_FALSE(log.enable(8u));
+
+    log.disable();
+    log.record(Trace::Event{.site = &site, .bytes = 2u});
+    ASSERT_TRUE(log.enable(8u));
+    size_t kept = 0u;
+    log.forEach([&](const Trace::Event&){ ++kept; });
+    EXPECT_EQ(0u, kept);
+}
+
+TEST(Trace, EventLogConcurrentWriters)
+{
+    static Trace::Site site{"Trace.EventLogConcurrentWriters"};
+    Trace::EventLog log;
+    ASSERT_TRUE(log.enable(16u));
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> writers;
+    for(DWORD writer = 1u; writer <= 4u; ++writer)
+    {
+        writers.emplace_back([&, writer]
+        {
+            while(!stop.load())
+            {
+                log.record(Trace::Event{.site = &site, .bytes = writer, .threadId = writer});
+            }
+        });
+    }
+    for(size_t pass = 0u; pass < 1000u; ++pass)
+    {
+        log.forEach([](const Trace::Event& event)
+        {
+            EXPECT_EQ(event.bytes, event.threadId);
+        });
+    }
+    stop.store(true);
+    for(auto& writer : writers)
+    {
+        writer.join();
+    }
+}
@@ -0,0 +1,73 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+#include <gtest/gtest.h>
+
+#include <Utils/Checksum.h>
+#include <string_view>
+#include <vector>
+
+using namespace Utils;
+
+namespace
+{
+
+std::span<const std::byte> bytesOf(const std::string_view text)
+{
+    return std::as_bytes(std::span{text.data(), text.size()});
+}
+
+template<typename H>
+typename H::Digest hashOf(H hasher, const std::string_view text)
+{
+    hasher.update(bytesOf(text));
+    return hasher.digest();
+}
+
+template<typename H>
+typename H::Digest hashInPieces(H hasher, const std::span<const std::byte> bytes, const size_t piece)
+{
+    for(size_t offset = 0u; offset < bytes.size(); offset += piece)
+    {
+        hasher.update(bytes.subspan(offset, std::min(piece, bytes.size() - offset)));
+    }
+    return hasher.digest();
+}
+
+} // namespace
+
+TEST(Checksum, Crc32cKnownValues)
+{
+    static_assert(IsHasher<Crc32c>);
+    for(const bool hardware : {false, true})
+    {
+        EXPECT_EQ(0x00000000u, hashOf(Crc32c{hardware}, ""));
+        EXPECT_EQ(0xE3069283u, hashOf(Crc32c{hardware}, "123456789"));
+        EXPECT_EQ(0x22620404u, hashOf(Crc32c{hardware}, "The quick brown fox jumps over the lazy dog"));
+    }
+}
+
+TEST(Checksum, XxHash64KnownValues)
+{
+    static_assert(IsHasher<XxHash64>);
+    EXPECT_EQ(0xEF46DB3751D8E999ull, hashOf(XxHash64{}, ""));
+    EXPECT_EQ(0x44BC2CF5AD770999ull, hashOf(XxHash64{}, "abc"));
+    EXPECT_EQ(0xFBCEA83C8A378BF1ull, hashOf(XxHash64{}, "Nobody inspects the spammish repetition"));
+}
+
+TEST(Checksum, StreamingMatchesOneShot)
+{
+    std::vector<std::byte> data(1000);
+    for(size_t index = 0u; index < data.size(); ++index)
+    {
+        data[index] = static_cast<std::byte>(index * 7u + 3u);
+    }
+    const auto crc = hashInPieces(Crc32c{false}, data, data.size());
+    const auto xx = hashInPieces(XxHash64{137u}, data, data.size());
+    for(const size_t piece : {1u, 3u, 7u, 31u, 32u, 33u, 100u})
+    {
+        EXPECT_EQ(crc, hashInPieces(Crc32c{false}, data, piece));
+        EXPECT_EQ(crc, hashInPieces(Crc32c{true}, data, piece));
+        EXPECT_EQ(xx, hashInPieces(XxHash64{137u}, data, piece));
+    }
+}
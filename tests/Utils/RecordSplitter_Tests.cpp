@@ -0,0 +1,84 @@
+//
+//  Copyright © 2021, Alexander Borisov,  https://github.com/SashaBorisov/CppWinApi
+//
+#include <gtest/gtest.h>
+
+#include <Utils/RecordSplitter.h>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Utils;
+
+namespace
+{
+
+std::span<const std::byte> bytesOf(const std::string_view text)
+{
+    return std::as_bytes(std::span{text.data(), text.size()});
+}
+
+std::string_view textOf(const std::span<const std::byte> bytes)
+{
+    return std::string_view{reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+std::vector<std::string_view> splitAll(const RecordSplitter& splitter, const std::string_view text)
+{
+    std::vector<std::string_view> records;
+    splitter.splitAll(bytesOf(text), [&](const std::span<const std::byte> record)
+    {
+        records.push_back(textOf(record));
+    });
+    return records;
+}
+
+} // namespace
+
+TEST(RecordSplitter, Simple)
+{
+    const RecordSplitter splitter;
+    const std::vector<std::string_view> expected{"one", "", "three", "tail"};
+    EXPECT_EQ(expected, splitAll(splitter, "one\n\nthree\ntail"));
+    EXPECT_TRUE(splitAll(splitter, "").empty());
+}
+
+TEST(RecordSplitter, ReturnsUnterminatedTail)
+{
+    const RecordSplitter splitter{std::byte{';'}};
+    size_t records = 0u;
+    const std::string_view text = "a;bb;ccc";
+    const auto tail = splitter.split(bytesOf(text), [&](std::span<const std::byte>)
+    {
+        ++records;
+    });
+    EXPECT_EQ(2u, records);
+    EXPECT_EQ("ccc", textOf(tail));
+    EXPECT_EQ(text.data() + 5, reinterpret_cast<const char*>(tail.data()));
+}
+
+TEST(RecordSplitter, AllLevelsAgree)
+{
+    std::mt19937 random{137u};
+    std::string text;
+    while(text.size() < 10000u)
+    {
+        text.append(random() % 70u, 'x');
+        text.push_back('\n');
+    }
+
+    const auto expected = splitAll(RecordSplitter{std::byte{'\n'}, SimdLevel::Scalar}, text);
+    ASSERT_LT(100u, expected.size());
+    for(const auto level : {SimdLevel::Sse2, SimdLevel::Avx2})
+    {
+        const RecordSplitter splitter{std::byte{'\n'}, level};
+        EXPECT_LE(splitter.simdLevel(), bestSimdLevel());
+        for(size_t offset = 0u; offset < 33u; ++offset)
+        {
+            const auto expectedTail = splitAll(RecordSplitter{std::byte{'\n'}, SimdLevel::Scalar}, std::string_view{text}.substr(offset));
+            EXPECT_EQ(expectedTail, splitAll(splitter, std::string_view{text}.substr(offset)));
+        }
+        EXPECT_EQ(expected, splitAll(splitter, text));
+    }
+}